@@ -0,0 +1,299 @@
+/**
+  **************************************************************************
+  * @file     ee_cfi.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host model of the external NOR/SRAM device, linux hosts
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "ee_cfi.h"
+#include "eeprom.h"
+
+#if (EE_BACKEND != EE_BACKEND_FMC)
+
+#define EE_CFI_DQ7               ((uint16_t)0x0080)                            /*!< data polling, complement of the programmed bit */
+#define EE_CFI_DQ6               ((uint16_t)0x0040)                            /*!< toggle bit */
+#define EE_CFI_DQ5               ((uint16_t)0x0020)                            /*!< exceeded timing limits */
+#define EE_CFI_WREN              ((uint32_t)0x00001000)                        /*!< EMMC bank write enable bit */
+#define EE_CFI_CYCLE_MASK        ((uint32_t)0x07FF)                            /*!< word address bits decoded in command cycles */
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE      0x100000                                      /*!< linux 4.17, older kernels take it as a hint */
+#endif
+
+/**
+  * @brief  command state of the device
+  */
+typedef enum
+{
+  EE_CFI_READ,                                                                 /*!< read array */
+  EE_CFI_UNLOCK1,                                                              /*!< AA written to 555 */
+  EE_CFI_UNLOCK2,                                                              /*!< 55 written to 2AA */
+  EE_CFI_PROGRAM,                                                              /*!< A0 written, the next write is programmed */
+  EE_CFI_ERASE_SETUP,                                                          /*!< 80 written */
+  EE_CFI_ERASE_UNLOCK1,                                                        /*!< AA written to 555 after 80 */
+  EE_CFI_ERASE_UNLOCK2,                                                        /*!< 55 written to 2AA after 80 */
+  EE_CFI_BUSY,                                                                 /*!< embedded algorithm running */
+  EE_CFI_FAILED                                                                /*!< algorithm failed or stuck, toggles until reset */
+} ee_cfi_state_type;
+
+ee_cfi_type ee_cfi;
+
+static ee_cfi_state_type ee_cfi_state;
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+static uint32_t ee_cfi_busy_reads;                                             /*!< status reads left of the running operation */
+static uint32_t ee_cfi_op_address;                                             /*!< halfword programmed or sector erased */
+static uint16_t ee_cfi_op_data;                                                /*!< halfword programmed */
+static uint8_t  ee_cfi_op_erase;                                               /*!< the operation is a sector erase */
+static uint16_t ee_cfi_status;                                                 /*!< status of the last read of the busy device */
+#endif
+
+/**
+  * @brief  map memory at a fixed address without replacing a mapping already there.
+  * @param  address: device address.
+  * @param  size: bytes.
+  * @retval 0: mapped, 1: the host refused the address or it is in use.
+  */
+static int ee_cfi_map(uint32_t address, uint32_t size)
+{
+  void* map;
+
+  /* a kernel older than 4.17 takes the address as a hint and may map elsewhere */
+  map = mmap((void*)(uintptr_t)address, size, PROT_READ | PROT_WRITE, MAP_FIXED_NOREPLACE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "ee_cfi: mapping 0x%08lX: ", (unsigned long)address);
+    perror(NULL);
+    return 1;
+  }
+
+  if (map != (void*)(uintptr_t)address)
+  {
+    fprintf(stderr, "ee_cfi: 0x%08lX is in use by the host process\n", (unsigned long)address);
+    munmap(map, size);
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  map the device and the EMMC bank registers, erased and write disabled.
+  * @param  none
+  * @retval 0: mapped, 1: the host refused the addresses or they are in use.
+  */
+int ee_cfi_init(void)
+{
+  if ((ee_cfi_map(EE_NOR_BANK_ADDRESS, EE_CFI_DEVICE_SIZE) != 0) || (ee_cfi_map((uint32_t)EMMC_Bank1_R_BASE, 4096) != 0))
+  {
+    return 1;
+  }
+
+  ee_cfi_reset();
+
+  return 0;
+}
+
+/**
+  * @brief  erase the whole device, return it to read mode and clear the counters and
+  *         the injected failures.
+  * @param  none
+  * @retval none
+  */
+void ee_cfi_reset(void)
+{
+  memset((void*)(uintptr_t)EE_NOR_BANK_ADDRESS, 0xFF, EE_CFI_DEVICE_SIZE);
+  memset(&ee_cfi, 0, sizeof(ee_cfi));
+
+  EMMC_Bank1->SNCTRL_T[EE_NOR_BANK] &= ~EE_CFI_WREN;
+
+  ee_cfi.program_reads = 2;
+  ee_cfi.erase_reads   = 20;
+  ee_cfi_state         = EE_CFI_READ;
+}
+
+/**
+  * @brief  check that the device is in read array mode.
+  * @param  none
+  * @retval 1: reads return the array, 0: a command or an operation is pending.
+  */
+int ee_cfi_ready(void)
+{
+  return (ee_cfi_state == EE_CFI_READ);
+}
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+/**
+  * @brief  start an embedded program or erase algorithm.
+  * @param  erase: 1 for a sector erase.
+  * @retval none
+  */
+static void ee_cfi_start(uint8_t erase, uint32_t address, uint16_t data)
+{
+  ee_cfi_fail_type fail = erase ? ee_cfi.erase_fail : ee_cfi.program_fail;
+
+  if (erase)
+  {
+    ee_cfi.erase_fail = EE_CFI_FAIL_NONE;
+  }
+  else
+  {
+    ee_cfi.program_fail = EE_CFI_FAIL_NONE;
+  }
+
+  ee_cfi_op_erase   = erase;
+  ee_cfi_op_address = erase ? (address - (address - EE_NOR_BANK_ADDRESS) % EE_NOR_SECTOR_SIZE) : address;
+  ee_cfi_op_data    = data;
+  ee_cfi_busy_reads = erase ? ee_cfi.erase_reads : ee_cfi.program_reads;
+  ee_cfi_status     = (fail == EE_CFI_FAIL_DQ5) ? EE_CFI_DQ5 : 0;
+  ee_cfi_state      = (fail == EE_CFI_FAIL_NONE) ? EE_CFI_BUSY : EE_CFI_FAILED;
+}
+
+/**
+  * @brief  complete the running algorithm, the array changes and reads return it.
+  * @param  none
+  * @retval none
+  */
+static void ee_cfi_complete(void)
+{
+  if (ee_cfi_op_erase)
+  {
+    memset((void*)(uintptr_t)ee_cfi_op_address, 0xFF, EE_NOR_SECTOR_SIZE);
+    ee_cfi.erases++;
+  }
+  else
+  {
+    /* a program clears bits, it never sets one */
+    *(uint16_t*)(uintptr_t)ee_cfi_op_address &= ee_cfi_op_data;
+    ee_cfi.programs++;
+  }
+
+  ee_cfi_state = EE_CFI_READ;
+}
+#endif
+
+/**
+  * @brief  write cycle of the bus.
+  * @param  address: bus address.
+  * @param  data: halfword.
+  * @retval none
+  */
+void ee_cfi_write(uint32_t address, uint16_t data)
+{
+  uint32_t cycle = ((address - EE_NOR_BANK_ADDRESS) >> 1) & EE_CFI_CYCLE_MASK;
+  ee_cfi_state_type next = EE_CFI_READ;
+
+  if (((EMMC_Bank1->SNCTRL_T[EE_NOR_BANK] & EE_CFI_WREN) == 0) || (address & 1) ||
+      (address < EE_NOR_BANK_ADDRESS) || (address - EE_NOR_BANK_ADDRESS >= EE_CFI_DEVICE_SIZE))
+  {
+    ee_cfi.ignored_writes++;
+    return;
+  }
+
+#if (EE_BACKEND == EE_BACKEND_SRAM)
+  (void)cycle;
+  (void)next;
+  *(uint16_t*)(uintptr_t)address = data;
+#else
+  /* the embedded algorithm ignores the bus, a failed one takes the reset only */
+  if ((ee_cfi_state == EE_CFI_BUSY) || ((ee_cfi_state == EE_CFI_FAILED) && (data != 0x00F0)))
+  {
+    ee_cfi.ignored_writes++;
+    return;
+  }
+
+  if ((data == 0x00F0) && (ee_cfi_state != EE_CFI_PROGRAM))
+  {
+    ee_cfi.resets++;
+    ee_cfi_state = EE_CFI_READ;
+    return;
+  }
+
+  switch (ee_cfi_state)
+  {
+    case EE_CFI_READ:
+      next = ((cycle == 0x0555) && (data == 0x00AA)) ? EE_CFI_UNLOCK1 : EE_CFI_READ;
+      break;
+
+    case EE_CFI_UNLOCK1:
+      next = ((cycle == 0x02AA) && (data == 0x0055)) ? EE_CFI_UNLOCK2 : EE_CFI_READ;
+      break;
+
+    case EE_CFI_UNLOCK2:
+      next = ((cycle == 0x0555) && (data == 0x00A0)) ? EE_CFI_PROGRAM :
+             ((cycle == 0x0555) && (data == 0x0080)) ? EE_CFI_ERASE_SETUP : EE_CFI_READ;
+      break;
+
+    case EE_CFI_PROGRAM:
+      ee_cfi_start(0, address, data);
+      return;
+
+    case EE_CFI_ERASE_SETUP:
+      next = ((cycle == 0x0555) && (data == 0x00AA)) ? EE_CFI_ERASE_UNLOCK1 : EE_CFI_READ;
+      break;
+
+    case EE_CFI_ERASE_UNLOCK1:
+      next = ((cycle == 0x02AA) && (data == 0x0055)) ? EE_CFI_ERASE_UNLOCK2 : EE_CFI_READ;
+      break;
+
+    case EE_CFI_ERASE_UNLOCK2:
+      if (data == 0x0030)
+      {
+        ee_cfi_start(1, address, data);
+        return;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  /* a cycle out of the sequence returns the device to read mode */
+  if (next == EE_CFI_READ)
+  {
+    ee_cfi.sequence_errors++;
+  }
+
+  ee_cfi_state = next;
+#endif
+}
+
+/**
+  * @brief  read cycle of the bus.
+  * @param  address: bus address.
+  * @retval the array halfword, or the status while an algorithm runs or failed.
+  */
+uint16_t ee_cfi_read(uint32_t address)
+{
+#if (EE_BACKEND == EE_BACKEND_NOR)
+  if ((ee_cfi_state == EE_CFI_BUSY) && (ee_cfi_busy_reads == 0))
+  {
+    ee_cfi_complete();
+  }
+
+  if ((ee_cfi_state == EE_CFI_BUSY) || (ee_cfi_state == EE_CFI_FAILED))
+  {
+    ee_cfi_busy_reads -= (ee_cfi_busy_reads > 0);
+    ee_cfi.status_reads++;
+
+    /* DQ6 toggles on every read, DQ7 is the complement of the programmed bit */
+    ee_cfi_status ^= EE_CFI_DQ6;
+
+    return (uint16_t)((ee_cfi_status & (EE_CFI_DQ6 | EE_CFI_DQ5)) |
+                      (ee_cfi_op_erase ? 0 : (~ee_cfi_op_data & EE_CFI_DQ7)));
+  }
+#endif
+
+  return *(__IO uint16_t*)(uintptr_t)address;
+}
+
+#endif
@@ -0,0 +1,86 @@
+/**
+  **************************************************************************
+  * @file     ee_cfi.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host model of the external NOR/SRAM device header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EE_CFI_H
+#define __EE_CFI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/*
+  the host tools build eeprom_nor.c and eeprom.c for the NOR or SRAM backend with this
+  header included first (-include Tools/ee_cfi.h): the bus cycles of the backend go to
+  the model, the plain loads of the emulator read the device memory mapped at
+  EE_NOR_BANK_ADDRESS, like the EMMC maps it.
+
+  the NOR model runs the CFI/AMD command set of a 16-bit device: the two unlock cycles,
+  word program (A0), sector erase (80, unlock, 30) and reset (F0). a program clears bits
+  only. a program or erase keeps the device busy for some reads, each read of the busy
+  device returns the status with DQ6 toggled, and the array changes when it completes.
+  an injected failure sets DQ5 and keeps the device toggling until a reset, a stuck
+  device toggles for ever. a cycle out of the sequence returns to read mode and counts
+  as a sequence error. the SRAM model takes every write as it comes.
+
+  like the EMMC, write cycles are ignored while the bank has no write enable.
+*/
+
+/*!< the bus cycles of eeprom_nor.c */
+#define EE_NOR_WRITE(address, data) ee_cfi_write(address, data)
+#define EE_NOR_READ(address)     ee_cfi_read(address)
+
+#define EE_CFI_DEVICE_SIZE       ((uint32_t)(1024 * 1024))                     /*!< device modelled, the lower 1MB the board wires */
+
+/**
+  * @brief  failure injected into the next operation of a kind
+  */
+typedef enum
+{
+  EE_CFI_FAIL_NONE,                                                            /*!< operations complete */
+  EE_CFI_FAIL_DQ5,                                                             /*!< exceeded timing limits, DQ5 set */
+  EE_CFI_FAIL_STUCK                                                            /*!< never completes, DQ6 toggles for ever */
+} ee_cfi_fail_type;
+
+/**
+  * @brief  device model state and counters
+  */
+typedef struct
+{
+  uint32_t program_reads;                                                      /*!< status reads a program keeps the device busy */
+  uint32_t erase_reads;                                                        /*!< status reads a sector erase keeps the device busy */
+  ee_cfi_fail_type program_fail;                                               /*!< injected into the next program, then cleared */
+  ee_cfi_fail_type erase_fail;                                                 /*!< injected into the next sector erase, then cleared */
+  uint32_t programs;                                                           /*!< halfwords programmed */
+  uint32_t erases;                                                             /*!< sectors erased */
+  uint32_t resets;                                                             /*!< reset commands */
+  uint32_t status_reads;                                                       /*!< reads of the busy device */
+  uint32_t sequence_errors;                                                    /*!< cycles out of a command sequence */
+  uint32_t ignored_writes;                                                     /*!< writes without write enable or while busy */
+} ee_cfi_type;
+
+extern ee_cfi_type ee_cfi;
+
+int      ee_cfi_init (void);
+void     ee_cfi_reset(void);
+int      ee_cfi_ready(void);
+void     ee_cfi_write(uint32_t address, uint16_t data);
+uint16_t ee_cfi_read (uint32_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,402 @@
+/**
+  **************************************************************************
+  * @file     ee_endurance.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host endurance and lifetime projection of the flash eeprom
+  **************************************************************************
+
+  build, from the Program directory, on a linux host:
+    cc -O2 -ITools -ITools/host -Iinc -I../../../Board -I../../../Library/APM32E10x_StdPeriphDriver/inc
+       -I../../../Library/CMSIS/Include -I../../../Library/Device/Geehy/APM32E10x/Include
+       -DAPM32E10X_HD -DAPM32E103_MINI -o ee_endurance Tools/ee_endurance.c Tools/ee_sim.c src/eeprom.c
+
+  usage:  ee_endurance [options]
+    -w n:s[:inc],...  write profile: n variables each written every s seconds, :inc for
+                      counters incremented instead (EE_COUNTER_TICKS enabled), default
+                      4:1,16:60,64:3600
+    -s n,n,...        sectors per page, 0 for the eeprom of flash_ee_init with its hot
+                      pages, others for a partition, default 0,1,2,4
+    -n cycles         erase endurance of a sector, default 10000
+    -y years          simulated time at most, default 30
+    -o ops            writes simulated at most per geometry, default 200000000
+    -l years          lifetime the product needs, default 10
+    -f kb             flash that could hold the eeprom, default 64
+
+  the profile runs on eeprom.c and the simulated flash of ee_sim.c as fast as the host
+  allows, the simulated clock only orders the writes. every sector ages by its erases
+  and fails to erase once worn, so a run ends at the first write the emulator cannot
+  complete, or at -y or -o. each page reports its erases and the years it lasts at the
+  simulated rate.
+
+  the eeprom moves between two pages, so its whole wear lands on 2 pages (4 with the hot
+  pages) however much flash is free. a geometry is flagged when:
+    PING-PONG  a page wears out before -l while the same erases spread over -f of flash
+               would last, larger pages spread them
+    UNEVEN     a page wears twice as fast as another one, e.g. the hot pages
+    WORN       the emulator failed a write within the simulated time
+    TOO BUSY   the erases wear -f of flash out before -l even when spread
+
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ee_sim.h"
+
+#define EE_ENDURANCE_BASE_ADDRESS ((uint32_t)(EE_SIM_FLASH_BASE + EE_SIM_FLASH_SIZE / 2)) /*!< partition of the simulation */
+#define EE_ENDURANCE_ENTRY_MAX   16                                            /*!< write profile entries */
+#define EE_ENDURANCE_CONFIG_MAX  16                                            /*!< geometries compared */
+#define EE_ENDURANCE_PAGE_MAX    4                                             /*!< pages of a geometry */
+#define EE_ENDURANCE_YEAR_S      (365.25 * 86400.0)                            /*!< seconds of a year */
+
+/**
+  * @brief  write profile entry
+  */
+typedef struct
+{
+  uint32_t count;                                                              /*!< variables */
+  double   period;                                                             /*!< seconds between two writes of a variable */
+  int      increment;                                                          /*!< counters incremented */
+  uint16_t address;                                                            /*!< variable address of the first one */
+  double   next;                                                               /*!< time of the next writes */
+} ee_endurance_entry_type;
+
+/**
+  * @brief  simulation limits and targets
+  */
+typedef struct
+{
+  double   years_max;                                                          /*!< simulated time at most */
+  double   ops_max;                                                            /*!< writes at most */
+  double   target_years;                                                       /*!< lifetime needed */
+  uint32_t free_sectors;                                                       /*!< sectors that could hold the eeprom */
+} ee_endurance_limit_type;
+
+static ee_endurance_entry_type entry[EE_ENDURANCE_ENTRY_MAX];
+static int entry_num;
+static ee_partition_type partition;
+
+/**
+  * @brief  write one variable of the profile.
+  * @param  sectors: 0 for the eeprom of flash_ee_init, else the partition.
+  * @retval flash status.
+  */
+static FMC_STATUS_T endurance_write(uint16_t sectors, const ee_endurance_entry_type* e, uint16_t address, uint16_t data)
+{
+#if (EE_COUNTER_TICKS > 0)
+  if (e->increment)
+  {
+    return (sectors == 0) ? flash_ee_counter_increment(address) : flash_ee_partition_counter_increment(&partition, address);
+  }
+#endif
+
+  return (sectors == 0) ? flash_ee_data_write(address, data) : flash_ee_partition_write(&partition, address, data);
+}
+
+/**
+  * @brief  get the highest erase count of the sectors of a page.
+  * @retval erases.
+  */
+static uint32_t page_erases(uint32_t page_address, uint32_t page_size)
+{
+  uint32_t s;
+  uint32_t erases = 0;
+
+  for (s = ee_sim_sector(page_address); s < ee_sim_sector(page_address + page_size); s++)
+  {
+    erases = (ee_sim.erase_count[s] > erases) ? ee_sim.erase_count[s] : erases;
+  }
+
+  return erases;
+}
+
+/**
+  * @brief  simulate the profile on one geometry and print its report.
+  * @param  sectors: sectors per page, 0 for the eeprom of flash_ee_init.
+  * @param  limit: simulation limits and targets.
+  * @retval none
+  */
+static void endurance_run(uint16_t sectors, const ee_endurance_limit_type* limit)
+{
+  int      i;
+  int      page_num = 2;
+  uint32_t v;
+  uint32_t s;
+  uint32_t used = 0;
+  uint32_t page_size;
+  uint32_t page_address[EE_ENDURANCE_PAGE_MAX];
+  uint32_t erases[EE_ENDURANCE_PAGE_MAX];
+  uint16_t data = 0;
+  double   now = 0;
+  double   end = limit->years_max * EE_ENDURANCE_YEAR_S;
+  double   ops = 0;
+  double   fail_time = -1;
+  double   years;
+  double   rate;
+  double   total_rate = 0;
+  double   worst = 0;
+  double   fastest = 0;
+  double   slowest = 0;
+  double   spread;
+  clock_t  host = clock();
+  ee_endurance_entry_type* e;
+  FMC_STATUS_T status = FMC_STATUS_COMPLETE;
+
+  ee_sim_reset();
+
+  if (sectors == 0)
+  {
+    status    = flash_ee_init();
+    page_size = EE_PAGE_SIZE;
+    page_address[0] = EE_PAGE0_ADDRESS;
+    page_address[1] = EE_PAGE1_ADDRESS;
+#if (EE_HOT_KEYS > 0)
+    page_address[2] = EE_HOT_BASE_ADDRESS;
+    page_address[3] = EE_HOT_BASE_ADDRESS + EE_PAGE_SIZE;
+    page_num = 4;
+#endif
+    printf("eeprom of flash_ee_init, %lu sectors per page%s\n", (unsigned long)EE_SECTOR_NUM, (page_num == 4) ? " and hot pages" : "");
+  }
+  else
+  {
+    status    = flash_ee_partition_init(&partition, EE_ENDURANCE_BASE_ADDRESS, sectors, EE_ADDRESS_MIN, EE_ADDRESS_MAX);
+    page_size = partition.page_size;
+    page_address[0] = partition.base_address;
+    page_address[1] = partition.base_address + page_size;
+    printf("partition, %u sectors per page\n", sectors);
+  }
+
+  if ((status != FMC_STATUS_COMPLETE) || (page_address[1] + page_size > EE_SIM_FLASH_BASE + EE_SIM_FLASH_SIZE))
+  {
+    printf("  does not fit the simulated flash\n\n");
+    return;
+  }
+
+  for (i = 0; i < entry_num; i++)
+  {
+    entry[i].next = 0;
+  }
+
+  /* the writes in time order, as fast as the host runs them */
+  while ((status == FMC_STATUS_COMPLETE) && (ops < limit->ops_max))
+  {
+    for (e = &entry[0], i = 1; i < entry_num; i++)
+    {
+      e = (entry[i].next < e->next) ? &entry[i] : e;
+    }
+
+    if (e->next >= end)
+    {
+      break;
+    }
+
+    now = e->next;
+
+    for (v = 0; (v < e->count) && (status == FMC_STATUS_COMPLETE); v++)
+    {
+      status = endurance_write(sectors, e, (uint16_t)(e->address + v), data++);
+      ops++;
+    }
+
+    e->next += e->period;
+  }
+
+  if (status != FMC_STATUS_COMPLETE)
+  {
+    fail_time = now;
+  }
+
+  years = now / EE_ENDURANCE_YEAR_S;
+
+  printf("  %.0f writes over %.2f simulated years, %.1f M writes/s on the host%s\n", ops, years,
+         ops / 1e6 / ((double)(clock() - host) / CLOCKS_PER_SEC + 1e-9),
+         (status != FMC_STATUS_COMPLETE) ? ", stopped at a failed write" :
+         (ops >= limit->ops_max) ? ", stopped at -o" : "");
+
+  if (years <= 0)
+  {
+    printf("\n");
+    return;
+  }
+
+  for (s = 0; s < EE_SIM_SECTORS; s++)
+  {
+    total_rate += ee_sim.erase_count[s] / years;
+    used       += (ee_sim.erase_count[s] != 0);
+  }
+
+  printf("  %-6s %-12s %10s %12s %14s\n", "page", "address", "erases", "erases/year", "years to wear");
+
+  for (i = 0; i < page_num; i++)
+  {
+    erases[i] = page_erases(page_address[i], page_size);
+    rate      = erases[i] / years;
+
+    printf("  %-6d 0x%08lX %10lu %12.1f ", i, (unsigned long)page_address[i], (unsigned long)erases[i], rate);
+
+    if (erases[i] == 0)
+    {
+      printf("%14s\n", "no wear");
+      continue;
+    }
+
+    printf("%14.1f\n", ee_sim.endurance / rate);
+
+    worst   = ((worst == 0) || (ee_sim.endurance / rate < worst)) ? ee_sim.endurance / rate : worst;
+    fastest = (rate > fastest) ? rate : fastest;
+    slowest = ((slowest == 0) || (rate < slowest)) ? rate : slowest;
+  }
+
+  if (total_rate == 0)
+  {
+    printf("  no erase in the simulated time\n\n");
+    return;
+  }
+
+  /* the lifetime of the same erases levelled over the free flash */
+  spread = ee_sim.endurance * (double)limit->free_sectors / total_rate;
+
+  if (fail_time >= 0)
+  {
+    printf("  WORN:      first failed write after %.2f years\n", fail_time / EE_ENDURANCE_YEAR_S);
+  }
+
+  if ((worst < limit->target_years) && (spread >= limit->target_years))
+  {
+    printf("  PING-PONG: %lu sectors take every erase and last %.1f years, spread over %lu sectors they would last %.1f\n",
+           (unsigned long)used, worst, (unsigned long)limit->free_sectors, spread);
+
+    if (sectors != 0)
+    {
+      printf("             about %.0f sectors per page reach %.0f years\n",
+             sectors * limit->target_years / worst + 0.5, limit->target_years);
+    }
+  }
+  else if (worst < limit->target_years)
+  {
+    printf("  TOO BUSY:  spread over %lu sectors the erases still wear out after %.1f years\n",
+           (unsigned long)limit->free_sectors, spread);
+  }
+
+  if ((slowest != 0) && (fastest > 2 * slowest))
+  {
+    printf("  UNEVEN:    the busiest page wears %.1f times as fast as the least busy one\n", fastest / slowest);
+  }
+
+  printf("\n");
+}
+
+/**
+  * @brief  parse a comma separated list.
+  * @retval items parsed.
+  */
+static int list_parse(char* text, char** item, int max)
+{
+  int num = 0;
+  char* next;
+
+  for (next = strtok(text, ","); (next != NULL) && (num < max); next = strtok(NULL, ","))
+  {
+    item[num++] = next;
+  }
+
+  return num;
+}
+
+int main(int argc, char** argv)
+{
+  char default_profile[] = "4:1,16:60,64:3600";
+  char default_sectors[] = "0,1,2,4";
+  char* profile_text = default_profile;
+  char* sectors_text = default_sectors;
+  char* item[EE_ENDURANCE_CONFIG_MAX];
+  char  kind[8];
+  uint16_t sectors[EE_ENDURANCE_CONFIG_MAX];
+  uint32_t address = (EE_ADDRESS_MIN > 0) ? EE_ADDRESS_MIN : 1;
+  uint32_t endurance = 10000;
+  ee_endurance_limit_type limit = { 30, 200e6, 10, 64 * 1024 / EE_SECTOR_SIZE };
+  int sector_num;
+  int i;
+  int arg;
+
+  for (arg = 1; (arg < argc - 1) && (argv[arg][0] == '-'); arg += 2)
+  {
+    switch (argv[arg][1])
+    {
+      case 'w': profile_text       = argv[arg + 1]; break;
+      case 's': sectors_text       = argv[arg + 1]; break;
+      case 'n': endurance          = (uint32_t)atol(argv[arg + 1]); break;
+      case 'y': limit.years_max    = atof(argv[arg + 1]); break;
+      case 'o': limit.ops_max      = atof(argv[arg + 1]); break;
+      case 'l': limit.target_years = atof(argv[arg + 1]); break;
+      case 'f': limit.free_sectors = (uint32_t)(atof(argv[arg + 1]) * 1024 / EE_SECTOR_SIZE); break;
+      default:  arg = argc; break;
+    }
+  }
+
+  if ((arg != argc) || (endurance == 0) || (limit.free_sectors == 0))
+  {
+    fprintf(stderr, "usage: %s [-w n:s[:inc],...] [-s sectors,...] [-n cycles] [-y years] [-o ops] [-l years] [-f kb]\n", argv[0]);
+    return 2;
+  }
+
+  entry_num = list_parse(profile_text, item, EE_ENDURANCE_ENTRY_MAX);
+
+  for (i = 0; i < entry_num; i++)
+  {
+    kind[0] = 0;
+
+    if ((sscanf(item[i], "%lu:%lf:%7s", (unsigned long*)&entry[i].count, &entry[i].period, kind) < 2) ||
+        (entry[i].count == 0) || (entry[i].period <= 0) || ((kind[0] != 0) && (strcmp(kind, "inc") != 0)))
+    {
+      fprintf(stderr, "bad profile entry %s\n", item[i]);
+      return 2;
+    }
+
+    entry[i].increment = (kind[0] != 0);
+
+#if (EE_COUNTER_TICKS == 0)
+    if (entry[i].increment)
+    {
+      fprintf(stderr, "profile entry %s increments counters, EE_COUNTER_TICKS is 0 in eeprom.h\n", item[i]);
+      return 2;
+    }
+#endif
+    entry[i].address   = (uint16_t)address;
+    address += entry[i].count;
+  }
+
+  if (address > EE_ADDRESS_MAX)
+  {
+    fprintf(stderr, "the profile has more variables than addresses\n");
+    return 2;
+  }
+
+  sector_num = list_parse(sectors_text, item, EE_ENDURANCE_CONFIG_MAX);
+
+  for (i = 0; i < sector_num; i++)
+  {
+    sectors[i] = (uint16_t)atoi(item[i]);
+  }
+
+  if (ee_sim_init() != 0)
+  {
+    return 1;
+  }
+
+  ee_sim.endurance = endurance;
+
+  printf("profile: %lu variables, endurance %lu erases, lifetime needed %.0f years, %lu sectors of flash free\n\n",
+         (unsigned long)(address - ((EE_ADDRESS_MIN > 0) ? EE_ADDRESS_MIN : 1)), (unsigned long)endurance,
+         limit.target_years, (unsigned long)limit.free_sectors);
+
+  for (i = 0; i < sector_num; i++)
+  {
+    endurance_run(sectors[i], &limit);
+  }
+
+  return 0;
+}
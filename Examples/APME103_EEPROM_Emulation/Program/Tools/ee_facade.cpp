@@ -0,0 +1,115 @@
+/**
+  **************************************************************************
+  * @file     ee_facade.cpp
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host check of the c++ facade of the flash eeprom
+  **************************************************************************
+
+  build and run, from the Program directory, on a linux host:
+    cc -O2 -c -ITools -ITools/host -Iinc -I../../../Board -I../../../Library/APM32E10x_StdPeriphDriver/inc
+       -I../../../Library/CMSIS/Include -I../../../Library/Device/Geehy/APM32E10x/Include
+       -DAPM32E10X_HD -DAPM32E103_MINI Tools/ee_sim.c src/eeprom.c
+    c++ -O2 -std=c++11 (same include and define options) -o ee_facade Tools/ee_facade.cpp ee_sim.o eeprom.o
+    ./ee_facade
+
+  the facade of eeprom.hpp drives the default eeprom and a partition of the simulated
+  flash of ee_sim.c: the layout constants are checked at compile time, the typed and
+  run time key accesses, the key range check and a reload at run time. prints ok and
+  exits with 0 when every check passes.
+
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include "ee_sim.h"
+#include "eeprom.hpp"
+
+#define EE_FACADE_BASE_ADDRESS   ((uint32_t)(EE_SIM_FLASH_BASE + EE_SIM_FLASH_SIZE / 2)) /*!< partition of the check */
+
+typedef ee::EepromEmulator<ee::FmcBackend, EE_PAGE_SIZE, 2, 64> settings;
+typedef ee::EepromEmulator<ee::FmcBackend, EE_SECTOR_SIZE * 2, 2, 100, EE_FACADE_BASE_ADDRESS> journal;
+typedef ee::EepromEmulator<ee::FmcBackend, EE_SECTOR_SIZE * 2, 2, 100, EE_FACADE_BASE_ADDRESS, false> journal_unchecked;
+
+enum
+{
+  SPEED_KEY = EE_ADDRESS_MIN + 3,                                              /*!< key of the default eeprom */
+  LIMIT_KEY = EE_ADDRESS_MIN + 7,                                              /*!< key of the partition */
+  COUNT_KEY = EE_ADDRESS_MIN + 9                                               /*!< counter key of the partition */
+};
+
+static_assert(settings::sector_num == EE_SECTOR_NUM, "the default eeprom takes EE_SECTOR_NUM sectors per page");
+static_assert(journal::sector_num == 2, "a partition page of two sectors");
+static_assert(journal::slot_num == EE_SECTOR_SIZE * 2 / 4, "one record slot per word");
+static_assert(journal::page_address(1) == EE_FACADE_BASE_ADDRESS + EE_SECTOR_SIZE * 2, "page 1 follows page 0");
+static_assert(journal::key_offset(3) == 14, "the key halfword follows the data halfword");
+static_assert(journal::valid_key(journal::key_max) && !journal::valid_key(journal::key_max + 1), "key range");
+
+/**
+  * @brief  report a failed check.
+  * @retval 1
+  */
+static int check_failed(const char* check)
+{
+  printf("failed: %s\n", check);
+  return 1;
+}
+
+int main(void)
+{
+  uint16_t data = 0;
+
+  if (ee_sim_init() != 0)
+  {
+    return 1;
+  }
+
+  if ((settings::init() != FMC_STATUS_COMPLETE) || (journal::init() != FMC_STATUS_COMPLETE))
+  {
+    return check_failed("init");
+  }
+
+  /* typed and run time key accesses */
+  if ((settings::write<SPEED_KEY>(55) != FMC_STATUS_COMPLETE) || (settings::read<SPEED_KEY>(data) != 0) || (data != 55))
+  {
+    return check_failed("typed key of the default eeprom");
+  }
+
+  if ((journal::write(LIMIT_KEY, 77) != FMC_STATUS_COMPLETE) || (journal::read(LIMIT_KEY, data) != 0) || (data != 77))
+  {
+    return check_failed("run time key of the partition");
+  }
+
+  /* a second facade of the same pages, without the run time key check */
+  if ((journal_unchecked::init() != FMC_STATUS_COMPLETE) || (journal_unchecked::read(LIMIT_KEY, data) != 0) || (data != 77))
+  {
+    return check_failed("unchecked read");
+  }
+
+  /* keys outside the layout are refused at run time */
+  if ((journal::write(journal::key_max + 1, 1) != FMC_STATUS_ERROR_PG) || (journal::read(journal::key_max + 1, data) != 1))
+  {
+    return check_failed("key range");
+  }
+
+#if (EE_COUNTER_TICKS > 0)
+  journal::increment<COUNT_KEY>();
+  journal::increment<COUNT_KEY>();
+
+  if ((journal::read<COUNT_KEY>(data) != 0) || (data != 2))
+  {
+    return check_failed("counter");
+  }
+#endif
+
+  /* the data survives a reload of both page pairs */
+  if ((settings::init() != FMC_STATUS_COMPLETE) || (journal::init() != FMC_STATUS_COMPLETE) ||
+      (settings::read<SPEED_KEY>(data) != 0) || (data != 55) || (journal::read<LIMIT_KEY>(data) != 0) || (data != 77))
+  {
+    return check_failed("reload");
+  }
+
+  printf("ok\n");
+
+  return 0;
+}
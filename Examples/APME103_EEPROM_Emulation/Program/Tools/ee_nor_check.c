@@ -0,0 +1,233 @@
+/**
+  **************************************************************************
+  * @file     ee_nor_check.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host check of the external NOR/SRAM backend on the device model
+  **************************************************************************
+
+  build and run, from the Program directory, on a linux host, once per backend:
+    cc -O2 -include Tools/ee_cfi.h -DEE_BACKEND=EE_BACKEND_NOR -ITools -ITools/host -Iinc -I../../../Board
+       -I../../../Library/APM32E10x_StdPeriphDriver/inc -I../../../Library/CMSIS/Include
+       -I../../../Library/Device/Geehy/APM32E10x/Include -DAPM32E10X_HD -DAPM32E103_MINI -o ee_nor_check
+       Tools/ee_nor_check.c Tools/ee_cfi.c src/eeprom.c src/eeprom_nor.c
+       ../../../Library/APM32E10x_StdPeriphDriver/src/apm32e10x_emmc.c
+       ../../../Library/APM32E10x_StdPeriphDriver/src/apm32e10x_gpio.c
+       ../../../Library/APM32E10x_StdPeriphDriver/src/apm32e10x_rcm.c
+    ./ee_nor_check
+  and the same with -DEE_BACKEND=EE_BACKEND_SRAM. the drivers only satisfy the link of
+  flash_ee_nor_init, which the check does not call.
+
+  the emulator runs a write workload with reloads on the model of ee_cfi.c and every
+  value is read back. the NOR build also drives the backend on a spare sector: the
+  command sequences, the DQ6 toggle polling, a program of a 0 back to 1, a DQ5 failure
+  and a stuck device for program and erase, and a DQ5 failure inside an emulator
+  write. every failure must leave the device in read mode, and no command cycle may
+  leave its sequence. writes of a locked bank must be ignored on both backends. prints
+  ok and exits with 0 when every check passes.
+
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ee_cfi.h"
+#include "eeprom.h"
+
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#error "build the check with -DEE_BACKEND=EE_BACKEND_NOR or -DEE_BACKEND=EE_BACKEND_SRAM"
+#endif
+
+#define EE_NOR_CHECK_KEYS        60                                            /*!< variables written */
+#define EE_NOR_CHECK_WRITES      40000                                         /*!< writes of the workload */
+#define EE_NOR_CHECK_RELOAD      4999                                          /*!< writes between two reloads */
+#define EE_NOR_CHECK_SPARE       ((uint32_t)(EE_NOR_BANK_ADDRESS + EE_CFI_DEVICE_SIZE - EE_NOR_SECTOR_SIZE)) /*!< sector outside the eeprom */
+
+static uint16_t reference[EE_NOR_CHECK_KEYS];
+
+/**
+  * @brief  report a failed check.
+  * @retval 1
+  */
+static int check_failed(const char* check)
+{
+  printf("failed: %s\n", check);
+  return 1;
+}
+
+/**
+  * @brief  read every variable back and compare it with the reference.
+  * @retval 0: all match, 1: a variable differs.
+  */
+static int check_values(void)
+{
+  uint16_t key;
+  uint16_t data;
+
+  for (key = 0; key < EE_NOR_CHECK_KEYS; key++)
+  {
+    if ((flash_ee_data_read((uint16_t)(EE_ADDRESS_MIN + key), &data) != 0) || (data != reference[key]))
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+/**
+  * @brief  drive the backend on the spare sector.
+  * @retval 0: every check passed, else 1.
+  */
+static int check_backend(void)
+{
+  __IO uint16_t* cell = (__IO uint16_t*)(uintptr_t)EE_NOR_CHECK_SPARE;
+  uint32_t status_reads = ee_cfi.status_reads;
+  FMC_STATUS_T status;
+
+  flash_ee_nor_unlock();
+
+  /* a program polls the toggle bit until the device is done */
+  if ((flash_ee_nor_halfword_program(EE_NOR_CHECK_SPARE, 0x12F0) != FMC_STATUS_COMPLETE) || (*cell != 0x12F0) ||
+      (ee_cfi.status_reads == status_reads) || !ee_cfi_ready())
+  {
+    return check_failed("halfword program");
+  }
+
+  /* a 0 cannot be programmed back to 1, the read back reports it */
+  if ((flash_ee_nor_halfword_program(EE_NOR_CHECK_SPARE, 0x34F0) != FMC_STATUS_ERROR_PG) || (*cell != 0x10F0))
+  {
+    return check_failed("program of a 0 back to 1");
+  }
+
+  /* DQ5 set while toggling fails the program and resets the device */
+  ee_cfi.program_fail = EE_CFI_FAIL_DQ5;
+
+  if ((flash_ee_nor_halfword_program(EE_NOR_CHECK_SPARE + 2, 0x5678) != FMC_STATUS_ERROR_PG) || !ee_cfi_ready() ||
+      (cell[1] != 0xFFFF))
+  {
+    return check_failed("program DQ5 failure");
+  }
+
+  /* a device toggling for ever times out and is reset */
+  ee_cfi.program_fail = EE_CFI_FAIL_STUCK;
+
+  if ((flash_ee_nor_halfword_program(EE_NOR_CHECK_SPARE + 2, 0x5678) != FMC_STATUS_TIMEOUT) || !ee_cfi_ready())
+  {
+    return check_failed("program timeout");
+  }
+
+  ee_cfi.erase_fail = EE_CFI_FAIL_DQ5;
+
+  if ((flash_ee_nor_sector_erase(EE_NOR_CHECK_SPARE) != FMC_STATUS_ERROR_PG) || !ee_cfi_ready() || (*cell != 0x10F0))
+  {
+    return check_failed("erase DQ5 failure");
+  }
+
+  ee_cfi.erase_fail = EE_CFI_FAIL_STUCK;
+
+  if ((flash_ee_nor_sector_erase(EE_NOR_CHECK_SPARE) != FMC_STATUS_TIMEOUT) || !ee_cfi_ready())
+  {
+    return check_failed("erase timeout");
+  }
+
+  if ((flash_ee_nor_sector_erase(EE_NOR_CHECK_SPARE) != FMC_STATUS_COMPLETE) || (*cell != 0xFFFF) || !ee_cfi_ready())
+  {
+    return check_failed("sector erase");
+  }
+
+  flash_ee_nor_lock();
+
+  /* a failed program inside a write leaves the variables as they were */
+  ee_cfi.program_fail = EE_CFI_FAIL_DQ5;
+  status = flash_ee_data_write(EE_ADDRESS_MIN, (uint16_t)(reference[0] + 1));
+
+  if ((status == FMC_STATUS_COMPLETE) || !ee_cfi_ready() || (flash_ee_init() != FMC_STATUS_COMPLETE) || check_values())
+  {
+    return check_failed("emulator write with a DQ5 failure");
+  }
+
+  return 0;
+}
+#endif
+
+int main(void)
+{
+  uint32_t n;
+  uint16_t key;
+  uint32_t ignored;
+
+  if ((ee_cfi_init() != 0))
+  {
+    return 1;
+  }
+
+  if ((flash_ee_init() != FMC_STATUS_COMPLETE) || !ee_cfi_ready())
+  {
+    return check_failed("init");
+  }
+
+  /* write workload with reloads, every value read back */
+  srand(1);
+
+  for (n = 0; n < EE_NOR_CHECK_WRITES; n++)
+  {
+    key = (uint16_t)(rand() % EE_NOR_CHECK_KEYS);
+    reference[key] = (uint16_t)rand();
+
+    if (flash_ee_data_write((uint16_t)(EE_ADDRESS_MIN + key), reference[key]) != FMC_STATUS_COMPLETE)
+    {
+      return check_failed("write");
+    }
+
+    if ((n % EE_NOR_CHECK_RELOAD) == 0)
+    {
+      flash_ee_init();
+    }
+  }
+
+  for (key = 0; key < EE_NOR_CHECK_KEYS; key++)
+  {
+    if (flash_ee_data_write((uint16_t)(EE_ADDRESS_MIN + key), reference[key]) != FMC_STATUS_COMPLETE)
+    {
+      return check_failed("write");
+    }
+  }
+
+  if ((flash_ee_init() != FMC_STATUS_COMPLETE) || check_values())
+  {
+    return check_failed("read back after reload");
+  }
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+  if (ee_cfi.erases == 0)
+  {
+    return check_failed("no page transfer in the workload");
+  }
+
+  if (check_backend() != 0)
+  {
+    return 1;
+  }
+#endif
+
+  /* the emulator leaves the bank write disabled, a stray store does not reach the device */
+  ignored = ee_cfi.ignored_writes;
+
+  if ((flash_ee_nor_halfword_program(EE_NOR_CHECK_SPARE + 4, 0x0000) != FMC_STATUS_ERROR_PG) ||
+      (ee_cfi.ignored_writes == ignored) || !ee_cfi_ready())
+  {
+    return check_failed("write of a locked bank");
+  }
+
+  if (ee_cfi.sequence_errors != 0)
+  {
+    return check_failed("command cycle out of its sequence");
+  }
+
+  printf("ok: %u writes, %u programs, %u erases, %u status reads, %u resets\n", (unsigned)EE_NOR_CHECK_WRITES,
+         (unsigned)ee_cfi.programs, (unsigned)ee_cfi.erases, (unsigned)ee_cfi.status_reads, (unsigned)ee_cfi.resets);
+
+  return 0;
+}
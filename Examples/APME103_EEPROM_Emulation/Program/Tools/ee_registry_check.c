@@ -0,0 +1,60 @@
+/**
+  **************************************************************************
+  * @file     ee_registry_check.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    compile checks of the typed registry access
+  **************************************************************************
+
+  check, from the Program directory, on a linux host:
+    for c in 0 1 2 3 4; do
+      cc -fsyntax-only -ITools/host -Iinc -I../../../Board -I../../../Library/APM32E10x_StdPeriphDriver/inc
+         -I../../../Library/CMSIS/Include -I../../../Library/Device/Geehy/APM32E10x/Include
+         -DAPM32E10X_HD -DAPM32E103_MINI -DEE_CHECK_CASE=$c Tools/ee_registry_check.c 2>/dev/null
+      echo "case $c: $?"
+    done
+
+  case 0 is correct access and must compile, every other case must fail to compile:
+    1  a pointer of the same size but another type
+    2  a pointer of another size
+    3  a key that is not in EE_REGISTRY
+    4  a write through a pointer of another type
+
+  **************************************************************************
+  */
+
+#include "eeprom_registry.h"
+
+#ifndef EE_CHECK_CASE
+#define EE_CHECK_CASE            0                                             /*!< access compiled */
+#endif
+
+#if (EE_GROUP_COMMIT > 0)
+void ee_registry_check(void)
+{
+  uint16_t limit = 0;
+  int16_t  offset = 0;
+  uint32_t count = 0;
+  const uint16_t default_limit = 1000;
+
+#if (EE_CHECK_CASE == 0)
+  EE_REGISTRY_READ(speed_limit, &limit);
+  EE_REGISTRY_READ(calibration, &offset);
+  EE_REGISTRY_READ(boot_count, &count);
+  EE_REGISTRY_WRITE(speed_limit, &default_limit);
+#elif (EE_CHECK_CASE == 1)
+  EE_REGISTRY_READ(speed_limit, &offset);
+#elif (EE_CHECK_CASE == 2)
+  EE_REGISTRY_READ(boot_count, &limit);
+#elif (EE_CHECK_CASE == 3)
+  EE_REGISTRY_READ(speed_limits, &limit);
+#elif (EE_CHECK_CASE == 4)
+  EE_REGISTRY_WRITE(calibration, &limit);
+#endif
+
+  (void)limit;
+  (void)offset;
+  (void)count;
+  (void)default_limit;
+}
+#endif
@@ -0,0 +1,658 @@
+/**
+  **************************************************************************
+  * @file     ee_replay.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host replay of a captured write stream for capacity planning
+  **************************************************************************
+
+  build, from the Program directory, on a linux host:
+    cc -O2 -ITools -ITools/host -Iinc -I../../../Board -I../../../Library/APM32E10x_StdPeriphDriver/inc
+       -I../../../Library/CMSIS/Include -I../../../Library/Device/Geehy/APM32E10x/Include
+       -DAPM32E10X_HD -DAPM32E103_MINI -o ee_replay Tools/ee_replay.c Tools/ee_sim.c src/eeprom.c
+
+  usage:  ee_replay [options] capture.bin
+    -s n,n,...     sectors per page of the replayed partition, default 1,2,4
+    -p policy,...  write policies, default all,changed
+                     all       every captured write
+                     changed   writes that change the stored value
+                     defer:S   the last value of each changed variable, written every S seconds
+    -r count       replays of the capture one after the other, default 1
+    -n cycles      erase endurance of a sector, default 10000
+    -t prog,erase  halfword program and sector erase time in us, default 52.5,20000
+
+  the capture comes from EE_CAPTURE_BYTES of eeprom_trace.h, the raw usart byte stream.
+  every configuration replays the write stream on an erased simulated flash through a
+  partition of eeprom.c, so the compile time options of eeprom.h apply as they are set.
+  the captured timestamps are kept: erases per day and the wear are for the captured
+  time, the lifetime projects the busiest sector to the erase endurance. a struct save
+  is replayed as its separate writes, without the group header, and counter increments
+  are replayed as they come under every policy, as a read and a write of the next value
+  when EE_COUNTER_TICKS is 0.
+
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ee_sim.h"
+#include "eeprom_trace.h"
+
+#define EE_REPLAY_BASE_ADDRESS   ((uint32_t)(EE_SIM_FLASH_BASE + EE_SIM_FLASH_SIZE / 2))  /*!< partition of the replay */
+#define EE_REPLAY_HEADER_SIZE    24                                            /*!< bytes of a capture frame header */
+#define EE_REPLAY_CONFIG_MAX     16                                            /*!< geometries or policies compared */
+
+/**
+  * @brief  captured write
+  */
+typedef struct
+{
+  uint64_t time;                                                               /*!< capture clock ticks from the first write */
+  uint8_t  kind;                                                               /*!< ee_capture_kind_type */
+  uint16_t address;                                                            /*!< variable address */
+  uint16_t data;                                                               /*!< data, halfwords for a group */
+} ee_replay_record_type;
+
+/**
+  * @brief  replay write policy
+  */
+typedef struct
+{
+  char     name[24];
+  int      skip_unchanged;                                                     /*!< write only values that differ */
+  double   defer_s;                                                            /*!< flush period of deferred writes, 0 writes at once */
+} ee_replay_policy_type;
+
+/**
+  * @brief  latency samples
+  */
+typedef struct
+{
+  double*  value;
+  size_t   count;
+  size_t   size;
+} ee_replay_samples_type;
+
+static ee_replay_record_type* record;
+static size_t   record_num;
+static uint32_t clock_hz;
+static uint32_t missed;
+static uint32_t frames_lost;
+
+static ee_partition_type partition;
+static uint16_t shadow[0x10000];                                               /*!< value written last per variable */
+static uint8_t  shadow_set[0x10000];
+static uint16_t pending[0x10000];                                              /*!< deferred value per variable */
+static uint8_t  pending_set[0x10000];
+static uint16_t pending_list[0x10000];
+static uint32_t pending_num;
+
+static ee_replay_samples_type write_latency;
+static ee_replay_samples_type transfer_latency;
+static uint64_t writes_issued;
+static uint64_t writes_failed;
+
+/**
+  * @brief  read a little endian halfword.
+  * @param  p: bytes.
+  * @retval halfword.
+  */
+static uint32_t get16(const uint8_t* p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+  * @brief  read a little endian word.
+  * @param  p: bytes.
+  * @retval word.
+  */
+static uint32_t get32(const uint8_t* p)
+{
+  return get16(p) | (get16(p + 2) << 16);
+}
+
+/**
+  * @brief  append a captured write.
+  * @retval none
+  */
+static void record_add(uint64_t time, uint8_t kind, uint16_t address, uint16_t data)
+{
+  static size_t size = 0;
+
+  if (record_num == size)
+  {
+    size   = (size == 0) ? 4096 : size * 2;
+    record = realloc(record, size * sizeof(*record));
+
+    if (record == NULL)
+    {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+  }
+
+  record[record_num].time    = time;
+  record[record_num].kind    = kind;
+  record[record_num].address = address;
+  record[record_num].data    = data;
+  record_num++;
+}
+
+/**
+  * @brief  decode the records of one capture frame.
+  * @param  frame: frame bytes, the header included.
+  * @param  time: time of the last record before the frame, updated.
+  * @param  last: capture clock of that record, updated.
+  * @retval 0: decoded, 1: the frame is damaged.
+  */
+static int frame_decode(const uint8_t* frame, uint64_t* time, uint32_t* last)
+{
+  const uint8_t* p   = frame + EE_REPLAY_HEADER_SIZE;
+  const uint8_t* end = p + get16(frame + 4);
+  uint32_t records   = get16(frame + 6);
+  uint32_t i;
+  uint64_t value;
+  int shift;
+
+  for (i = 0; i < records; i++)
+  {
+    value = 0;
+    shift = 0;
+
+    do
+    {
+      if ((p >= end) || (shift > 35))
+      {
+        return 1;
+      }
+
+      value |= (uint64_t)(*p & 0x7F) << shift;
+      shift += 7;
+    } while (*p++ & 0x80);
+
+    if (p + (((value & 3) == EE_CAPTURE_INCREMENT) ? 2 : 4) > end)
+    {
+      return 1;
+    }
+
+    *time += value >> 2;
+    *last += (uint32_t)(value >> 2);
+
+    if ((value & 3) == EE_CAPTURE_INCREMENT)
+    {
+      record_add(*time, EE_CAPTURE_INCREMENT, (uint16_t)get16(p), 0);
+      p += 2;
+    }
+    else
+    {
+      record_add(*time, (uint8_t)(value & 3), (uint16_t)get16(p), (uint16_t)get16(p + 2));
+      p += 4;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  load the frames of a capture, in sequence order.
+  * @param  name: capture file.
+  * @retval 0: records loaded, 1: none.
+  */
+static int capture_load(const char* name)
+{
+  FILE* file;
+  uint8_t* data;
+  long size;
+  size_t i;
+  size_t frame_size;
+  size_t* frame = NULL;
+  size_t frame_num = 0;
+  size_t j;
+  size_t k;
+  uint32_t expect = 0;
+  uint32_t last = 0;
+  uint64_t time = 0;
+
+  if ((file = fopen(name, "rb")) == NULL)
+  {
+    perror(name);
+    return 1;
+  }
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  data  = malloc((size > 0) ? (size_t)size : 1);
+  frame = malloc(((size_t)size / EE_REPLAY_HEADER_SIZE + 1) * sizeof(*frame));
+
+  if ((data == NULL) || (frame == NULL) || (fread(data, 1, (size_t)size, file) != (size_t)size))
+  {
+    fprintf(stderr, "%s: read failed\n", name);
+    return 1;
+  }
+
+  fclose(file);
+
+  /* frames start at the magic, bytes between frames are skipped */
+  for (i = 0; i + EE_REPLAY_HEADER_SIZE <= (size_t)size; )
+  {
+    frame_size = EE_REPLAY_HEADER_SIZE + get16(data + i + 4);
+
+    if ((get32(data + i) == EE_CAPTURE_MAGIC) && (i + frame_size <= (size_t)size))
+    {
+      frame[frame_num++] = i;
+      i += frame_size;
+    }
+    else
+    {
+      i++;
+    }
+  }
+
+  /* a capture file may hold several sends, order the frames by sequence */
+  for (j = 1; j < frame_num; j++)
+  {
+    for (k = j; (k > 0) && (get32(data + frame[k - 1] + 16) > get32(data + frame[k] + 16)); k--)
+    {
+      i = frame[k];
+      frame[k] = frame[k - 1];
+      frame[k - 1] = i;
+    }
+  }
+
+  for (j = 0; j < frame_num; j++)
+  {
+    const uint8_t* f = data + frame[j];
+
+    if ((j > 0) && (get32(f + 16) == get32(data + frame[j - 1] + 16)))
+    {
+      continue;
+    }
+
+    if (j == 0)
+    {
+      clock_hz = get32(f + 8);
+      last     = get32(f + 12);
+    }
+    else if (get32(f + 16) != expect)
+    {
+      /* frames lost, their time is bridged by the start of this one */
+      frames_lost += get32(f + 16) - expect;
+      time += (uint32_t)(get32(f + 12) - last);
+      last  = get32(f + 12);
+    }
+
+    expect = get32(f + 16) + 1;
+    missed = get32(f + 20);
+
+    if (frame_decode(f, &time, &last) != 0)
+    {
+      fprintf(stderr, "%s: frame %lu damaged, its remaining records are skipped\n", name, (unsigned long)get32(f + 16));
+    }
+  }
+
+  free(frame);
+  free(data);
+
+  return (record_num == 0) || (clock_hz == 0);
+}
+
+/**
+  * @brief  add a latency sample.
+  * @retval none
+  */
+static void sample_add(ee_replay_samples_type* samples, double value)
+{
+  if (samples->count == samples->size)
+  {
+    samples->size  = (samples->size == 0) ? 1024 : samples->size * 2;
+    samples->value = realloc(samples->value, samples->size * sizeof(double));
+
+    if (samples->value == NULL)
+    {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+  }
+
+  samples->value[samples->count++] = value;
+}
+
+static int sample_compare(const void* a, const void* b)
+{
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+  * @brief  get a percentile of sorted samples.
+  * @retval sample, 0 without samples.
+  */
+static double sample_percentile(const ee_replay_samples_type* samples, double percent)
+{
+  size_t i;
+
+  if (samples->count == 0)
+  {
+    return 0;
+  }
+
+  i = (size_t)(percent / 100.0 * (samples->count - 1) + 0.5);
+
+  return samples->value[i];
+}
+
+/**
+  * @brief  write a variable to the replay partition and sample its flash time.
+  * @param  kind: EE_CAPTURE_WRITE or EE_CAPTURE_INCREMENT.
+  * @retval none
+  */
+static void replay_write(uint8_t kind, uint16_t address, uint16_t data)
+{
+  double   busy   = ee_sim.busy_us;
+  uint64_t erases = ee_sim.erases;
+  FMC_STATUS_T status;
+
+  if (kind == EE_CAPTURE_INCREMENT)
+  {
+#if (EE_COUNTER_TICKS > 0)
+    status = flash_ee_partition_counter_increment(&partition, address);
+#else
+    /* without counters an increment is a read and a write of the next value */
+    data = 0;
+    flash_ee_partition_read(&partition, address, &data);
+    status = flash_ee_partition_write(&partition, address, (uint16_t)(data + 1));
+#endif
+  }
+  else
+  {
+    status = flash_ee_partition_write(&partition, address, data);
+  }
+
+  writes_issued++;
+
+  if (status != FMC_STATUS_COMPLETE)
+  {
+    writes_failed++;
+  }
+
+  /* a write that erased waited for a page transfer */
+  if (ee_sim.erases != erases)
+  {
+    sample_add(&transfer_latency, ee_sim.busy_us - busy);
+  }
+  else
+  {
+    sample_add(&write_latency, ee_sim.busy_us - busy);
+  }
+}
+
+/**
+  * @brief  write the deferred variables.
+  * @retval none
+  */
+static void replay_flush(void)
+{
+  uint32_t i;
+  uint16_t address;
+
+  for (i = 0; i < pending_num; i++)
+  {
+    address = pending_list[i];
+    pending_set[address] = 0;
+
+    if (!shadow_set[address] || (shadow[address] != pending[address]))
+    {
+      shadow[address]     = pending[address];
+      shadow_set[address] = 1;
+      replay_write(EE_CAPTURE_WRITE, address, pending[address]);
+    }
+  }
+
+  pending_num = 0;
+}
+
+/**
+  * @brief  replay the capture under one geometry and policy and print its line.
+  * @param  sectors: sectors per page.
+  * @param  policy: write policy.
+  * @param  repeat: replays of the capture.
+  * @param  endurance: erase endurance of a sector.
+  * @retval none
+  */
+static void replay_run(uint16_t sectors, const ee_replay_policy_type* policy, unsigned repeat, double endurance)
+{
+  size_t   i;
+  unsigned r;
+  uint32_t s;
+  uint32_t sector_max = 0;
+  uint64_t span  = record[record_num - 1].time + 1;
+  uint64_t defer = (uint64_t)(policy->defer_s * clock_hz);
+  uint64_t next_flush = defer;
+  uint64_t time;
+  double   days;
+  double   erase_day;
+  double   life_years;
+
+  ee_sim_reset();
+  memset(shadow_set, 0, sizeof(shadow_set));
+  memset(pending_set, 0, sizeof(pending_set));
+  pending_num = 0;
+  write_latency.count    = 0;
+  transfer_latency.count = 0;
+  writes_issued = 0;
+  writes_failed = 0;
+
+  if (flash_ee_partition_init(&partition, EE_REPLAY_BASE_ADDRESS, sectors, EE_ADDRESS_MIN, EE_ADDRESS_MAX) != FMC_STATUS_COMPLETE)
+  {
+    printf("%7u %-12s partition does not fit the simulated flash\n", sectors, policy->name);
+    return;
+  }
+
+  for (r = 0; r < repeat; r++)
+  {
+    for (i = 0; i < record_num; i++)
+    {
+      time = record[i].time + r * span;
+
+      if (record[i].kind == EE_CAPTURE_GROUP)
+      {
+        continue;
+      }
+
+      if (defer != 0)
+      {
+        while (time >= next_flush)
+        {
+          replay_flush();
+          next_flush += defer;
+        }
+      }
+
+      if (record[i].kind == EE_CAPTURE_INCREMENT)
+      {
+        replay_write(EE_CAPTURE_INCREMENT, record[i].address, 0);
+      }
+      else if (defer != 0)
+      {
+        if (!pending_set[record[i].address])
+        {
+          pending_set[record[i].address]  = 1;
+          pending_list[pending_num++] = record[i].address;
+        }
+
+        pending[record[i].address] = record[i].data;
+      }
+      else if (!policy->skip_unchanged || !shadow_set[record[i].address] || (shadow[record[i].address] != record[i].data))
+      {
+        shadow[record[i].address]     = record[i].data;
+        shadow_set[record[i].address] = 1;
+        replay_write(EE_CAPTURE_WRITE, record[i].address, record[i].data);
+      }
+    }
+  }
+
+  replay_flush();
+
+  for (s = 0; s < EE_SIM_SECTORS; s++)
+  {
+    sector_max = (ee_sim.erase_count[s] > sector_max) ? ee_sim.erase_count[s] : sector_max;
+  }
+
+  qsort(write_latency.value, write_latency.count, sizeof(double), sample_compare);
+  qsort(transfer_latency.value, transfer_latency.count, sizeof(double), sample_compare);
+
+  days       = (double)span * repeat / clock_hz / 86400.0;
+  erase_day  = (double)ee_sim.erases / days;
+  life_years = (sector_max == 0) ? 0 : endurance / (sector_max / days) / 365.0;
+
+  printf("%7u %-12s %10llu %9llu %8llu %10.1f %7lu %7.1f %7.1f %7.1f %8.1f ",
+         sectors, policy->name, (unsigned long long)writes_issued, (unsigned long long)ee_sim.programs,
+         (unsigned long long)ee_sim.erases, erase_day, (unsigned long)transfer_latency.count,
+         sample_percentile(&transfer_latency, 50) / 1000.0, sample_percentile(&transfer_latency, 99) / 1000.0,
+         sample_percentile(&transfer_latency, 100) / 1000.0, sample_percentile(&write_latency, 99));
+
+  if (sector_max == 0)
+  {
+    printf("%10s", "no erase");
+  }
+  else
+  {
+    printf("%10.1f", life_years);
+  }
+
+  if (writes_failed != 0)
+  {
+    printf("  %llu writes failed", (unsigned long long)writes_failed);
+  }
+
+  printf("\n");
+}
+
+/**
+  * @brief  parse a comma separated list of values.
+  * @retval values parsed.
+  */
+static int list_parse(char* text, char** item, int max)
+{
+  int num = 0;
+  char* next;
+
+  for (next = strtok(text, ","); (next != NULL) && (num < max); next = strtok(NULL, ","))
+  {
+    item[num++] = next;
+  }
+
+  return num;
+}
+
+int main(int argc, char** argv)
+{
+  char default_sectors[] = "1,2,4";
+  char default_policies[] = "all,changed";
+  char* sectors_text = default_sectors;
+  char* policies_text = default_policies;
+  char* item[EE_REPLAY_CONFIG_MAX];
+  uint16_t sectors[EE_REPLAY_CONFIG_MAX];
+  ee_replay_policy_type policy[EE_REPLAY_CONFIG_MAX];
+  int sector_num;
+  int policy_num;
+  unsigned repeat = 1;
+  double endurance = 10000;
+  double program_us = EE_SIM_PROGRAM_US;
+  double erase_us = EE_SIM_ERASE_US;
+  int i;
+  int j;
+  int arg;
+
+  for (arg = 1; (arg < argc - 1) && (argv[arg][0] == '-'); arg += 2)
+  {
+    switch (argv[arg][1])
+    {
+      case 's': sectors_text  = argv[arg + 1]; break;
+      case 'p': policies_text = argv[arg + 1]; break;
+      case 'r': repeat        = (unsigned)atoi(argv[arg + 1]); break;
+      case 'n': endurance     = atof(argv[arg + 1]); break;
+      case 't':
+        if (sscanf(argv[arg + 1], "%lf,%lf", &program_us, &erase_us) != 2)
+        {
+          arg = argc;
+        }
+        break;
+      default:  arg = argc; break;
+    }
+  }
+
+  if ((arg != argc - 1) || (repeat == 0))
+  {
+    fprintf(stderr, "usage: %s [-s sectors,...] [-p all|changed|defer:S,...] [-r repeat] [-n cycles] [-t prog_us,erase_us] capture.bin\n", argv[0]);
+    return 2;
+  }
+
+  sector_num = list_parse(sectors_text, item, EE_REPLAY_CONFIG_MAX);
+
+  for (i = 0; i < sector_num; i++)
+  {
+    sectors[i] = (uint16_t)atoi(item[i]);
+  }
+
+  policy_num = list_parse(policies_text, item, EE_REPLAY_CONFIG_MAX);
+
+  for (i = 0; i < policy_num; i++)
+  {
+    memset(&policy[i], 0, sizeof(policy[i]));
+    snprintf(policy[i].name, sizeof(policy[i].name), "%s", item[i]);
+
+    if (strcmp(item[i], "changed") == 0)
+    {
+      policy[i].skip_unchanged = 1;
+    }
+    else if (strncmp(item[i], "defer:", 6) == 0)
+    {
+      policy[i].defer_s = atof(item[i] + 6);
+    }
+    else if (strcmp(item[i], "all") != 0)
+    {
+      fprintf(stderr, "unknown policy %s\n", item[i]);
+      return 2;
+    }
+  }
+
+  if (ee_sim_init() != 0)
+  {
+    return 1;
+  }
+
+  ee_sim.program_us = program_us;
+  ee_sim.erase_us   = erase_us;
+
+  if (capture_load(argv[arg]) != 0)
+  {
+    fprintf(stderr, "%s: no capture records\n", argv[arg]);
+    return 1;
+  }
+
+  printf("capture: %lu records over %.2f hours at %lu Hz, %lu records and %lu frames missed\n",
+         (unsigned long)record_num, (double)record[record_num - 1].time / clock_hz / 3600.0,
+         (unsigned long)clock_hz, (unsigned long)missed, (unsigned long)frames_lost);
+  printf("replay:  %u times, erase endurance %.0f cycles, program %.1fus, erase %.1fms\n\n",
+         repeat, endurance, ee_sim.program_us, ee_sim.erase_us / 1000.0);
+  printf("%7s %-12s %10s %9s %8s %10s %7s %7s %7s %7s %8s %10s\n",
+         "sectors", "policy", "writes", "programs", "erases", "erases/day",
+         "xfers", "p50 ms", "p99 ms", "max ms", "wr p99us", "life years");
+
+  for (i = 0; i < sector_num; i++)
+  {
+    for (j = 0; j < policy_num; j++)
+    {
+      replay_run(sectors[i], &policy[j], repeat, endurance);
+    }
+  }
+
+  return 0;
+}
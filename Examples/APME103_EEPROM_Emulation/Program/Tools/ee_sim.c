@@ -0,0 +1,224 @@
+/**
+  **************************************************************************
+  * @file     ee_sim.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    simulated flash of the host tools, linux hosts
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "ee_sim.h"
+#include "eeprom_trace.h"
+
+#define EE_SIM_INFO_PAGE         ((uint32_t)0x1FFFF000)                        /*!< page of the flash size register */
+#define EE_SIM_FLASH_SIZE_REG    ((uint32_t)0x1FFFF7E0)                        /*!< flash size in KB, read by EE_FLASH_SIZE */
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE      0x100000                                      /*!< linux 4.17, older kernels take it as a hint */
+#endif
+
+ee_sim_type ee_sim;
+
+static int ee_sim_locked = 1;
+
+/**
+  * @brief  map memory at a fixed address without replacing a mapping already there.
+  * @param  address: device address.
+  * @param  size: bytes.
+  * @retval 0: mapped, 1: the host refused the address or it is in use.
+  */
+static int ee_sim_map(uint32_t address, uint32_t size)
+{
+  void* map;
+
+  /* a kernel older than 4.17 takes the address as a hint and may map elsewhere */
+  map = mmap((void*)(uintptr_t)address, size, PROT_READ | PROT_WRITE, MAP_FIXED_NOREPLACE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "ee_sim: mapping 0x%08lX: ", (unsigned long)address);
+    perror(NULL);
+    return 1;
+  }
+
+  if (map != (void*)(uintptr_t)address)
+  {
+    fprintf(stderr, "ee_sim: 0x%08lX is in use by the host process\n", (unsigned long)address);
+    munmap(map, size);
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  map the simulated flash at its device address, erased.
+  * @param  none
+  * @retval 0: the flash is mapped, 1: the host refused the addresses or they are in use.
+  */
+int ee_sim_init(void)
+{
+  if ((ee_sim_map(EE_SIM_FLASH_BASE, EE_SIM_FLASH_SIZE) != 0) || (ee_sim_map(EE_SIM_INFO_PAGE, 4096) != 0))
+  {
+    return 1;
+  }
+
+  *(uint16_t*)(uintptr_t)EE_SIM_FLASH_SIZE_REG = (uint16_t)(EE_SIM_FLASH_SIZE / 1024);
+
+  ee_sim.program_us = EE_SIM_PROGRAM_US;
+  ee_sim.erase_us   = EE_SIM_ERASE_US;
+  ee_sim.endurance  = 0;
+  ee_sim_reset();
+
+  return 0;
+}
+
+/**
+  * @brief  erase the whole simulated flash and clear the counters, the timing and the
+  *         endurance are kept.
+  * @param  none
+  * @retval none
+  */
+void ee_sim_reset(void)
+{
+  memset((void*)(uintptr_t)EE_SIM_FLASH_BASE, 0xFF, EE_SIM_FLASH_SIZE);
+  memset(ee_sim.erase_count, 0, sizeof(ee_sim.erase_count));
+
+  ee_sim.busy_us  = 0;
+  ee_sim.programs = 0;
+  ee_sim.erases   = 0;
+}
+
+/**
+  * @brief  get the sector of a flash address.
+  * @param  address: flash address.
+  * @retval sector number from the flash base.
+  */
+uint32_t ee_sim_sector(uint32_t address)
+{
+  return (address - EE_SIM_FLASH_BASE) / EE_SECTOR_SIZE;
+}
+
+/**
+  * @brief  check that an access stays inside the simulated flash.
+  * @param  address: first address.
+  * @param  size: bytes.
+  * @retval 0: inside, 1: outside.
+  */
+static int ee_sim_outside(uint32_t address, uint32_t size)
+{
+  return (address < EE_SIM_FLASH_BASE) || (address - EE_SIM_FLASH_BASE + size > EE_SIM_FLASH_SIZE);
+}
+
+void FMC_Unlock(void)
+{
+  ee_sim_locked = 0;
+}
+
+void FMC_Lock(void)
+{
+  ee_sim_locked = 1;
+}
+
+FMC_STATUS_T FMC_ProgramHalfWord(uint32_t address, uint16_t data)
+{
+  uint16_t* cell = (uint16_t*)(uintptr_t)address;
+
+  if (ee_sim_locked || (address & 1) || ee_sim_outside(address, 2))
+  {
+    return FMC_STATUS_ERROR_WRP;
+  }
+
+  /* like the device, an erased halfword takes any data and a programmed one only zero */
+  if ((*cell != 0xFFFF) && (data != 0))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  *cell = data;
+
+  ee_sim.programs++;
+  ee_sim.busy_us += ee_sim.program_us;
+
+  return FMC_STATUS_COMPLETE;
+}
+
+FMC_STATUS_T FMC_ProgramBuffer(uint32_t address, const uint16_t* data, uint32_t count)
+{
+  uint32_t i;
+  FMC_STATUS_T status = FMC_STATUS_COMPLETE;
+
+  for (i = 0; (i < count) && (status == FMC_STATUS_COMPLETE); i++)
+  {
+    status = FMC_ProgramHalfWord(address + i * 2, data[i]);
+  }
+
+  return status;
+}
+
+FMC_STATUS_T FMC_ErasePage(uint32_t pageAddr)
+{
+  if (ee_sim_locked || ((pageAddr - EE_SIM_FLASH_BASE) % EE_SECTOR_SIZE) || ee_sim_outside(pageAddr, EE_SECTOR_SIZE))
+  {
+    return FMC_STATUS_ERROR_WRP;
+  }
+
+  ee_sim.busy_us += ee_sim.erase_us;
+
+  /* a worn sector no longer erases */
+  if ((ee_sim.endurance != 0) && (ee_sim.erase_count[ee_sim_sector(pageAddr)] >= ee_sim.endurance))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  memset((void*)(uintptr_t)pageAddr, 0xFF, EE_SECTOR_SIZE);
+
+  ee_sim.erase_count[ee_sim_sector(pageAddr)]++;
+  ee_sim.erases++;
+
+  return FMC_STATUS_COMPLETE;
+}
+
+FMC_STATUS_T FMC_EraseRange(uint32_t pageAddr, uint32_t pageNum, uint32_t* failAddr)
+{
+  FMC_STATUS_T status = FMC_STATUS_COMPLETE;
+
+  for (; pageNum > 0; pageNum--, pageAddr += EE_SECTOR_SIZE)
+  {
+    if ((status = FMC_ErasePage(pageAddr)) != FMC_STATUS_COMPLETE)
+    {
+      if (failAddr != NULL)
+      {
+        *failAddr = pageAddr;
+      }
+
+      break;
+    }
+  }
+
+  return status;
+}
+
+/*!< the trace and capture calls of an eeprom.c built with them enabled have nothing to record on the host */
+#if (EE_TRACE_EVENTS > 0)
+__attribute__((weak)) void flash_ee_trace_record(ee_trace_event_type event, uint8_t status, uint16_t key, uint32_t argument)
+{
+}
+
+__attribute__((weak)) FMC_STATUS_T flash_ee_trace_check(FMC_STATUS_T flash_status, uint32_t address)
+{
+  return flash_status;
+}
+#endif
+
+#if (EE_CAPTURE_BYTES > 0)
+__attribute__((weak)) void flash_ee_capture_record(ee_capture_kind_type kind, uint16_t address, uint16_t data)
+{
+}
+#endif
@@ -0,0 +1,65 @@
+/**
+  **************************************************************************
+  * @file     ee_sim.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    simulated flash of the host tools header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EE_SIM_H
+#define __EE_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  the host tools run eeprom.c unchanged on a simulated internal flash: the flash is
+  mapped at its device address, so that the emulator reads it directly, and the FMC
+  program and erase calls of the emulator are served here. like the device, a halfword
+  is only programmed when erased or to zero.
+
+  every program and erase adds its typical duration to a simulated busy time, and every
+  sector counts its erases. with an endurance set, a sector erased that many times is
+  worn: its erase fails and leaves it as it is.
+*/
+
+#define EE_SIM_FLASH_BASE        ((uint32_t)0x08000000)                        /*!< device address of the flash */
+#define EE_SIM_FLASH_SIZE        ((uint32_t)(512 * 1024))                      /*!< flash simulated */
+#define EE_SIM_SECTORS           (EE_SIM_FLASH_SIZE / EE_SECTOR_SIZE)          /*!< sectors simulated */
+#define EE_SIM_PROGRAM_US        52.5                                          /*!< default halfword program time */
+#define EE_SIM_ERASE_US          20000.0                                       /*!< default sector erase time */
+
+/**
+  * @brief  simulated flash state
+  */
+typedef struct
+{
+  double   program_us;                                                         /*!< halfword program time */
+  double   erase_us;                                                           /*!< sector erase time */
+  uint32_t endurance;                                                          /*!< erases a sector survives, 0 for no wear out */
+  double   busy_us;                                                            /*!< time spent programming and erasing */
+  uint64_t programs;                                                           /*!< halfwords programmed */
+  uint64_t erases;                                                             /*!< sectors erased */
+  uint32_t erase_count[EE_SIM_SECTORS];                                        /*!< erases of each sector */
+} ee_sim_type;
+
+extern ee_sim_type ee_sim;
+
+int      ee_sim_init  (void);
+void     ee_sim_reset (void);
+uint32_t ee_sim_sector(uint32_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
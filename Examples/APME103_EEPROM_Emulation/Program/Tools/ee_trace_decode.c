@@ -0,0 +1,301 @@
+/**
+  **************************************************************************
+  * @file     ee_trace_decode.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host decoder of the flash eeprom trace frames of eeprom_trace.h
+  **************************************************************************
+
+  build:  cc -O2 -o ee_trace_decode ee_trace_decode.c
+  usage:  ee_trace_decode [-f cpu_hz] capture.bin
+
+  the capture is the raw byte stream of the board usart, e.g. saved by a terminal program.
+  every frame found in it is printed as a timeline, oldest event first, with the time
+  since the previous event and the duration of each page transfer. with -f the
+  timestamps of the default cycle counter clock are printed in microseconds.
+
+  **************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define EE_TRACE_MAGIC           0x52544545UL                                  /*!< "EETR", first word of a frame */
+#define EE_TRACE_HEADER_SIZE     16                                            /*!< magic, entry size, entries, head, missed */
+#define EE_TRACE_ENTRY_SIZE      12                                            /*!< timestamp, event, status, key, argument */
+
+/*!< event and recovery action names, as numbered in eeprom_trace.h */
+static const char* const event_name[] =
+{
+  "?", "WRITE", "ELIDED", "INCREMENT", "GROUP", "TRANSFER", "TRANSFER_END", "ERASE", "RECOVER", "FMC_ERROR"
+};
+
+static const char* const action_name[] =
+{
+  "?", "format", "mark valid", "resume transfer", "rollback group"
+};
+
+/*!< FMC_STATUS_T names */
+static const char* const status_name[] =
+{
+  "", "BUSY", "ERROR_PG", "ERROR_WRP", "COMPLETE", "TIMEOUT"
+};
+
+static double cpu_hz = 0;                                                      /*!< clock of the timestamps, 0 prints ticks */
+
+/**
+  * @brief  read a little endian halfword.
+  * @param  p: bytes.
+  * @retval halfword.
+  */
+static uint32_t get16(const uint8_t* p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+  * @brief  read a little endian word.
+  * @param  p: bytes.
+  * @retval word.
+  */
+static uint32_t get32(const uint8_t* p)
+{
+  return get16(p) | (get16(p + 2) << 16);
+}
+
+/**
+  * @brief  print a time in ticks, or in microseconds with -f.
+  * @param  ticks: clock ticks.
+  * @retval none
+  */
+static void print_time(uint32_t ticks)
+{
+  if (cpu_hz > 0)
+  {
+    printf("%12.1fus", ticks * 1e6 / cpu_hz);
+  }
+  else
+  {
+    printf("%12lu", (unsigned long)ticks);
+  }
+}
+
+/**
+  * @brief  print the key and argument of an event.
+  * @param  event: event.
+  * @param  key: event key.
+  * @param  argument: event argument.
+  * @retval none
+  */
+static void print_detail(unsigned event, uint32_t key, uint32_t argument)
+{
+  switch (event)
+  {
+    case 1:  printf("var 0x%04lX = 0x%04lX", (unsigned long)key, (unsigned long)argument); break;
+    case 2:  printf("var 0x%04lX, 0x%lX skipped", (unsigned long)key, (unsigned long)argument); break;
+    case 3:  printf("var 0x%04lX", (unsigned long)key); break;
+    case 4:  printf("struct at var 0x%04lX, %lu halfwords", (unsigned long)key, (unsigned long)argument); break;
+    case 5:  printf("from page 0x%08lX", (unsigned long)argument); break;
+    case 6:  printf("to page 0x%08lX, %lu records", (unsigned long)argument, (unsigned long)key); break;
+    case 7:  printf("page 0x%08lX, %lu sectors", (unsigned long)argument, (unsigned long)key); break;
+    case 8:  printf("%s, pages at 0x%08lX", (key < 5) ? action_name[key] : "?", (unsigned long)argument); break;
+    case 9:  printf("address 0x%08lX, FMC STS 0x%04lX", (unsigned long)argument, (unsigned long)key); break;
+    default: printf("key 0x%04lX argument 0x%08lX", (unsigned long)key, (unsigned long)argument); break;
+  }
+}
+
+/**
+  * @brief  print one frame as a timeline.
+  * @param  frame: frame bytes, the header included.
+  * @param  size: bytes available from the frame on.
+  * @retval bytes of the frame, 0 when it is not complete.
+  */
+static size_t decode_frame(const uint8_t* frame, size_t size)
+{
+  uint32_t entry_size;
+  uint32_t entry_num;
+  uint32_t head;
+  uint32_t missed;
+  uint32_t count;
+  uint32_t i;
+  uint32_t last = 0;
+  uint32_t transfer_start = 0;
+  int transfer_open = 0;
+  uint32_t transfers = 0;
+  uint32_t transfer_min = 0xFFFFFFFFUL;
+  uint32_t transfer_max = 0;
+  double   transfer_sum = 0;
+  uint32_t event_count[10] = {0};
+  const uint8_t* entry;
+
+  if (size < EE_TRACE_HEADER_SIZE)
+  {
+    return 0;
+  }
+
+  entry_size = get16(frame + 4);
+  entry_num  = get16(frame + 6);
+  head       = get32(frame + 8);
+  missed     = get32(frame + 12);
+
+  if ((entry_size != EE_TRACE_ENTRY_SIZE) || (entry_num == 0) ||
+      (size < EE_TRACE_HEADER_SIZE + (size_t)entry_num * entry_size))
+  {
+    return 0;
+  }
+
+  /* the ring holds the last entry_num events, the oldest at head */
+  count = (head < entry_num) ? head : entry_num;
+
+  printf("frame: %lu events recorded, last %lu kept, %lu missed while sending\n",
+         (unsigned long)head, (unsigned long)count, (unsigned long)missed);
+  printf("%10s %12s %12s  %-13s %-9s\n", "event", "time", "delta", "type", "status");
+
+  for (i = 0; i < count; i++)
+  {
+    uint32_t seq = head - count + i;
+    uint32_t timestamp;
+    unsigned event;
+    unsigned status;
+    uint32_t key;
+    uint32_t argument;
+
+    entry     = frame + EE_TRACE_HEADER_SIZE + (size_t)(seq % entry_num) * entry_size;
+    timestamp = get32(entry);
+    event     = entry[4];
+    status    = entry[5];
+    key       = get16(entry + 6);
+    argument  = get32(entry + 8);
+
+    printf("%10lu ", (unsigned long)seq);
+    print_time(timestamp);
+    printf(" ");
+    print_time((i == 0) ? 0 : timestamp - last);
+    printf("  %-13s %-9s ", (event < 10) ? event_name[event] : "?", (status < 6) ? status_name[status] : "?");
+    print_detail(event, key, argument);
+
+    event_count[(event < 10) ? event : 0]++;
+
+    if (event == 5)
+    {
+      transfer_start = timestamp;
+      transfer_open  = 1;
+    }
+    else if ((event == 6) && transfer_open)
+    {
+      /* the timestamps are free running, the difference survives a wrap */
+      uint32_t duration = timestamp - transfer_start;
+
+      printf("  (transfer ");
+      print_time(duration);
+      printf(")");
+
+      transfers++;
+      transfer_sum += duration;
+      transfer_min  = (duration < transfer_min) ? duration : transfer_min;
+      transfer_max  = (duration > transfer_max) ? duration : transfer_max;
+      transfer_open = 0;
+    }
+    else if (event == 8)
+    {
+      transfer_open = 0;
+    }
+
+    printf("\n");
+    last = timestamp;
+  }
+
+  printf("summary:");
+  for (i = 1; i < 10; i++)
+  {
+    if (event_count[i] != 0)
+    {
+      printf(" %s %lu", event_name[i], (unsigned long)event_count[i]);
+    }
+  }
+  printf("\n");
+
+  if (transfers != 0)
+  {
+    printf("transfers: %lu, min ", (unsigned long)transfers);
+    print_time(transfer_min);
+    printf(" avg ");
+    print_time((uint32_t)(transfer_sum / transfers));
+    printf(" max ");
+    print_time(transfer_max);
+    printf("\n");
+  }
+
+  printf("\n");
+
+  return EE_TRACE_HEADER_SIZE + (size_t)entry_num * entry_size;
+}
+
+int main(int argc, char** argv)
+{
+  FILE* file;
+  uint8_t* data;
+  long size;
+  size_t i;
+  size_t used;
+  unsigned frames = 0;
+  int arg = 1;
+
+  if ((argc > 2) && (strcmp(argv[1], "-f") == 0))
+  {
+    cpu_hz = atof(argv[2]);
+    arg = 3;
+  }
+
+  if (arg != argc - 1)
+  {
+    fprintf(stderr, "usage: %s [-f cpu_hz] capture.bin\n", argv[0]);
+    return 2;
+  }
+
+  if ((file = fopen(argv[arg], "rb")) == NULL)
+  {
+    perror(argv[arg]);
+    return 1;
+  }
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  data = malloc((size > 0) ? (size_t)size : 1);
+
+  if ((data == NULL) || (fread(data, 1, (size_t)size, file) != (size_t)size))
+  {
+    fprintf(stderr, "%s: read failed\n", argv[arg]);
+    return 1;
+  }
+
+  fclose(file);
+
+  /* frames start at the magic, bytes between frames are skipped */
+  for (i = 0; i + 4 <= (size_t)size; )
+  {
+    if ((get32(data + i) == EE_TRACE_MAGIC) && ((used = decode_frame(data + i, (size_t)size - i)) != 0))
+    {
+      frames++;
+      i += used;
+    }
+    else
+    {
+      i++;
+    }
+  }
+
+  free(data);
+
+  if (frames == 0)
+  {
+    fprintf(stderr, "%s: no complete trace frame\n", argv[arg]);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,47 @@
+/**
+  **************************************************************************
+  * @file     cmsis_gcc.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    host stand-in of the cmsis compiler header, lets the host tools
+  *           build the eeprom sources with the host compiler
+  **************************************************************************
+
+  the core intrinsics have no effect on the host, the host tools run the emulator on a
+  single thread.
+
+  **************************************************************************
+  */
+
+#ifndef __CMSIS_GCC_H
+#define __CMSIS_GCC_H
+
+#include <stdint.h>
+
+#define __ASM                    __asm
+#define __INLINE                 inline
+#define __STATIC_INLINE          static inline
+#define __STATIC_FORCEINLINE     static inline
+#define __NO_RETURN              __attribute__((__noreturn__))
+#define __USED                   __attribute__((used))
+#define __WEAK                   __attribute__((weak))
+#define __PACKED                 __attribute__((packed))
+#define __PACKED_STRUCT          struct __attribute__((packed))
+#define __PACKED_UNION           union __attribute__((packed))
+#define __ALIGNED(x)             __attribute__((aligned(x)))
+#define __RESTRICT               __restrict
+#define __COMPILER_BARRIER()     __asm volatile("" ::: "memory")
+
+static inline void     __enable_irq(void)            { }
+static inline void     __disable_irq(void)           { }
+static inline uint32_t __get_PRIMASK(void)           { return 0; }
+static inline void     __set_PRIMASK(uint32_t value) { (void)value; }
+static inline void     __DSB(void)                   { __COMPILER_BARRIER(); }
+static inline void     __ISB(void)                   { __COMPILER_BARRIER(); }
+static inline void     __DMB(void)                   { __COMPILER_BARRIER(); }
+static inline void     __NOP(void)                   { }
+static inline void     __WFI(void)                   { }
+static inline uint32_t __CLZ(uint32_t value)         { return (value != 0) ? (uint32_t)__builtin_clz(value) : 32; }
+static inline uint32_t __REV(uint32_t value)         { return __builtin_bswap32(value); }
+
+#endif
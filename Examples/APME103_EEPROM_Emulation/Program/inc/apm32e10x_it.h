@@ -1,25 +1,26 @@
-/*!
- * @file        apm32e10x_it.h
- *
- * @brief       This file contains the headers of the interrupt handlers
- *
- * @version     V1.0.0
- *
- * @date        2021-07-26
- *
- */
- 
-#ifndef __APM32E10x_IT_H
-#define __APM32E10x_IT_H
-
-void NMI_Handler(void);
-void HardFault_Handler(void);
-void MemManage_Handler(void);
-void BusFault_Handler(void);
-void UsageFault_Handler(void);
-void SVC_Handler(void);
-void DebugMon_Handler(void);
-void PendSV_Handler(void);
-void SysTick_Handler(void);
-#endif
-
+/*!
+ * @file        apm32e10x_it.h
+ *
+ * @brief       This file contains the headers of the interrupt handlers
+ *
+ * @version     V1.0.0
+ *
+ * @date        2021-07-26
+ *
+ */
+ 
+#ifndef __APM32E10x_IT_H
+#define __APM32E10x_IT_H
+
+void NMI_Handler(void);
+void HardFault_Handler(void);
+void MemManage_Handler(void);
+void BusFault_Handler(void);
+void UsageFault_Handler(void);
+void SVC_Handler(void);
+void DebugMon_Handler(void);
+void PendSV_Handler(void);
+void SysTick_Handler(void);
+void FMC_IRQHandler(void);
+#endif
+
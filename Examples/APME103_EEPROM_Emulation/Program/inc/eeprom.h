@@ -1,66 +1,231 @@
-/**
-  **************************************************************************
-  * @file     eeprom.h
-  * @version  v1.0.0
-  * @date     2022-08-15
-  * @brief    flash eeprom libray header file
-  **************************************************************************
-
-  *
-  **************************************************************************
-  */
-
-/*!< define to prevent recursive inclusion -------------------------------------*/
-#ifndef __EEPROM_H
-#define __EEPROM_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/* includes ------------------------------------------------------------------*/
-#include "main.h"
-
-/*
-  +-----------------------------------------------------+
-  |                        EEPROM                       |
-  +--------------------------+--------------------------+
-  |          PAGE 0          |          PAGE 1          |
-  +--------+--------+--------+--------+--------+--------+
-  |        |        |        |        |        |        |
-  | sector | sector | sector | sector | sector | sector |
-  |   0    |  ...   |   N    | N + 1  |  ...   |  N + N |
-  |        |        |        |        |        |        |
-  +--------+--------+--------+--------+--------+--------+
-*/
-
-/*!< user defined */ 
-#define EE_SECTOR_NUM            ((uint32_t)1)                                 /*!< sector number, support multiple sectors to from 1 page */
-#define EE_SECTOR_SIZE           ((uint32_t)(1024 * 2))                        /*!< sector size */
-
-/*!< user do not need to care */ 
-#define EE_FLASH_SIZE            ((*(uint16_t *)0x1FFFF7E0) & 0xFFFF)	                   /*!< APM32 flash size information */ 
-
-#define EE_PAGE_SIZE             ((uint32_t)(EE_SECTOR_NUM * EE_SECTOR_SIZE))  /*!< page size */
-
-#define EE_BASE_ADDRESS          ((uint32_t)(0x08000000 + 1024 * EE_FLASH_SIZE - EE_PAGE_SIZE * 2)) /*!< eeprom base address */    
-#define EE_PAGE0_ADDRESS         ((uint32_t)(EE_BASE_ADDRESS))                 /*!< eeprom page 0 base address */
-#define EE_PAGE1_ADDRESS         ((uint32_t)(EE_PAGE0_ADDRESS + EE_PAGE_SIZE)) /*!< eeprom page 1 base address */
-
-#define EE_PARA_MAX_NUMBER       ((uint16_t)(EE_PAGE_SIZE / 4 - 1))            /*!< maximum number of variables that can be stored */ 
-
-FMC_STATUS_T flash_ee_init       (void);
-uint16_t          flash_ee_data_read  (uint16_t address, uint16_t* pdata);
-FMC_STATUS_T flash_ee_data_write (uint16_t address, uint16_t data);
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif
-
-
-
-
-
-
+/**
+  **************************************************************************
+  * @file     eeprom.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom libray header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_H
+#define __EEPROM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/*
+  +-----------------------------------------------------+
+  |                        EEPROM                       |
+  +--------------------------+--------------------------+
+  |          PAGE 0          |          PAGE 1          |
+  +--------+--------+--------+--------+--------+--------+
+  |        |        |        |        |        |        |
+  | sector | sector | sector | sector | sector | sector |
+  |   0    |  ...   |   N    | N + 1  |  ...   |  N + N |
+  |        |        |        |        |        |        |
+  +--------+--------+--------+--------+--------+--------+
+
+  with EE_HOT_KEYS enabled a second page pair of the same layout, the hot pages, holds
+  the few variables that take most of the writes, so that their page transfers do not
+  recopy the rarely written variables.
+
+  with EE_PACKED_KEYS enabled a page holds the 4-byte records from its start and the
+  packed halfwords from its end:
+
+  +--------+---------+---------+-----+--------+-----+---------+---------+
+  | header | record  | record  | ... | erased | ... | packed  | packed  |
+  +--------+---------+---------+-----+--------+-----+---------+---------+
+
+  with EE_COUNTER_TICKS enabled, which excludes EE_PACKED_KEYS, the page end holds the
+  counter runs: a header (record slot, variable address) and the ticks below it. each
+  tick of the newest run of a counter adds one to the record at that slot:
+
+  +--------+---------+---------+-----+--------+------------------+------------------+
+  | header | record  | record  | ... | erased | ticks | run head | ticks | run head |
+  +--------+---------+---------+-----+--------+------------------+------------------+
+
+  with EE_THREAD_SAFE enabled the writes, the init and the passes over all variables take
+  the lock given to flash_ee_lock_register one at a time. a read takes no lock: it reads
+  again when a writer published a change meanwhile, and while a writer is busy it scans
+  the valid page published last instead of using the ram state being changed.
+*/
+
+/*!< storage backend */
+#define EE_BACKEND_FMC           0                                             /*!< internal flash programmed through the FMC */
+#define EE_BACKEND_NOR           1                                             /*!< parallel NOR flash on the EMMC bank 1, CFI command set */
+#define EE_BACKEND_SRAM          2                                             /*!< battery-backed SRAM or PSRAM on the EMMC bank 1 */
+
+/*!< user defined */ 
+#ifndef EE_BACKEND
+#define EE_BACKEND               EE_BACKEND_FMC                                /*!< storage backend the emulator runs on, can be set on the compiler command line */
+#endif
+#define EE_SECTOR_NUM            ((uint32_t)1)                                 /*!< sector number, support multiple sectors to from 1 page */
+
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#define EE_SECTOR_SIZE           FMC_PAGE_SIZE                                 /*!< sector size */
+#else
+#include "eeprom_nor.h"
+#define EE_SECTOR_SIZE           EE_NOR_SECTOR_SIZE                            /*!< sector size */
+#endif
+
+/*!< user do not need to care */ 
+#define EE_FLASH_SIZE            ((*(uint16_t *)0x1FFFF7E0) & 0xFFFF)	                   /*!< APM32 flash size information */ 
+
+#define EE_PAGE_SIZE             ((uint32_t)(EE_SECTOR_NUM * EE_SECTOR_SIZE))  /*!< page size */
+
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#define EE_BASE_ADDRESS          ((uint32_t)(0x08000000 + 1024 * EE_FLASH_SIZE - EE_PAGE_SIZE * 2)) /*!< eeprom base address */    
+#else
+#define EE_BASE_ADDRESS          ((uint32_t)(EE_NOR_BANK_ADDRESS + EE_NOR_OFFSET)) /*!< eeprom base address */
+#endif
+#define EE_PAGE0_ADDRESS         ((uint32_t)(EE_BASE_ADDRESS))                 /*!< eeprom page 0 base address */
+#define EE_PAGE1_ADDRESS         ((uint32_t)(EE_PAGE0_ADDRESS + EE_PAGE_SIZE)) /*!< eeprom page 1 base address */
+
+#define EE_PARA_MAX_NUMBER       ((uint16_t)(EE_PAGE_SIZE / 4 - 1))            /*!< maximum number of variables that can be stored */ 
+
+/*!< user defined, the hot page pair takes 2 * EE_PAGE_SIZE more flash: on the FMC backend
+     just below the eeprom, to be kept out of the application area of the linker script */
+#define EE_HOT_KEYS              0                                             /*!< most written variables kept in a separate hot page pair, 0 disables it */
+#define EE_HOT_PROMOTE           16                                            /*!< writes counted before a variable moves to the hot pages */
+
+/*!< user do not need to care */
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#define EE_HOT_BASE_ADDRESS      ((uint32_t)(EE_BASE_ADDRESS - EE_PAGE_SIZE * 2)) /*!< hot page pair, just below the eeprom */
+#else
+#define EE_HOT_BASE_ADDRESS      ((uint32_t)(EE_BASE_ADDRESS + EE_PAGE_SIZE * 2)) /*!< hot page pair, just above the eeprom */
+#endif
+
+/*!< user defined */
+#define EE_COUNTER_TICKS         16                                            /*!< halfword ticks of a counter run, one per increment before a new record, 0 disables counters */
+#define EE_RECORD_INVALIDATE     0                                             /*!< 1: zero the variable address of a superseded record, variable address 0 is then reserved */
+#define EE_GROUP_COMMIT          1                                             /*!< 1: struct saves commit their changed fields as one atomic group, 0 disables structs */
+
+/*!< user defined, packed variables hold 0 to 0xFF and cost one halfword program per write */
+#define EE_PACKED_KEYS           0                                             /*!< variables stored as a single 8-bit key/8-bit value halfword, 255 at most, 0 disables them */
+#define EE_PACKED_BASE_ADDRESS   ((uint16_t)0xF000)                            /*!< variable address of packed key 0, the packed variables follow it */
+
+/*!< variable addresses may use the 16-bit range from EE_ADDRESS_MIN to EE_ADDRESS_MAX */
+#define EE_ADDRESS_ERASED        ((uint16_t)0xFFFF)                            /*!< reserved, reads as an empty location */
+#define EE_ADDRESS_GROUP         ((uint16_t)0xFFFD)                            /*!< reserved for group headers when EE_GROUP_COMMIT is enabled */
+#define EE_ADDRESS_DEAD          ((uint16_t)0x0000)                            /*!< reserved for superseded records when EE_RECORD_INVALIDATE is enabled */
+#define EE_ADDRESS_MIN           ((EE_RECORD_INVALIDATE > 0) ? (uint16_t)0x0001 : (uint16_t)0x0000) /*!< lowest variable address */
+#define EE_ADDRESS_MAX           ((EE_GROUP_COMMIT > 0) ? (uint16_t)0xFFFC : (uint16_t)0xFFFE) /*!< highest variable address */
+
+/*!< user defined */
+#define EE_INDEX_BITS            8                                             /*!< ram index of 2^bits entries (3 bytes each), must exceed the live variable count, 0 disables it */
+
+/*!< user do not need to care */
+#define EE_INDEX_SIZE            ((EE_INDEX_BITS > 0) ? (1 << EE_INDEX_BITS) : 0) /*!< number of index entries */
+
+/*!< user defined */
+#define EE_TRACE_EVENTS          0                                             /*!< operations kept in the ram trace ring of eeprom_trace.h (12 bytes each), 0 disables it */
+#define EE_CAPTURE_BYTES         0                                             /*!< bytes of each of the two ram buffers the write stream of eeprom_trace.h is captured in, 0 disables it */
+#define EE_THREAD_SAFE           0                                             /*!< 1: writers are serialized by the lock of flash_ee_lock_register, reads never wait */
+
+/**
+  * @brief  flash eeprom partition, a page pair with its own geometry, variable address range
+  *         and transfer cycle. the geometry is resolved once by flash_ee_partition_init.
+  */
+typedef struct
+{
+  uint32_t base_address;                                                       /*!< page 0 address, page 1 follows it */
+  uint32_t sector_size;                                                        /*!< erase unit of the backend */
+  uint32_t page_size;                                                          /*!< sector_size * sector_num, below 256K */
+  uint16_t sector_num;                                                         /*!< sectors per page */
+  uint16_t address_min;                                                        /*!< lowest variable address accepted */
+  uint16_t address_max;                                                        /*!< highest variable address accepted */
+#if (EE_THREAD_SAFE > 0)
+  uint32_t read_address;                                                       /*!< valid page published to the readers, 0 when there is none */
+#endif
+} ee_partition_type;
+
+/**
+  * @brief  flash eeprom live record iterator, returns every stored variable once with its
+  *         newest data. the cursor is only valid while no write is issued to the eeprom.
+  */
+typedef struct
+{
+  uint32_t page_address;                                                       /*!< valid page the cursor walks */
+  uint32_t find_address;                                                       /*!< next variable address location, scanned backwards */
+#if (EE_HOT_KEYS > 0)
+  uint16_t hot_entry;                                                          /*!< next hot variable entry, returned before the page records */
+#endif
+#if (EE_PACKED_KEYS > 0)
+  uint32_t packed_address;                                                     /*!< next packed record, returned after the page records */
+  uint32_t packed_seen[(EE_PACKED_KEYS + 31) / 32];                            /*!< packed variables already returned */
+#endif
+  uint32_t seen[(EE_PARA_MAX_NUMBER + 31) / 32];                               /*!< variables below EE_PARA_MAX_NUMBER already returned */
+} ee_iterator_type;
+
+#if (EE_GROUP_COMMIT > 0)
+/**
+  * @brief  flash eeprom struct field, a field of size bytes is stored as (size + 1) / 2
+  *         variables from address on, low byte first.
+  */
+typedef struct
+{
+  uint16_t offset;                                                             /*!< byte offset of the field in the struct */
+  uint16_t size;                                                               /*!< field width in bytes */
+  uint16_t address;                                                            /*!< variable address of the first halfword */
+} ee_field_type;
+
+/**
+  * @brief  flash eeprom struct layout. the image is the struct as last committed, a save
+  *         writes the halfwords that differ from it as one group.
+  */
+typedef struct
+{
+  const ee_field_type* fields;                                                 /*!< field table */
+  uint16_t field_num;                                                          /*!< number of fields */
+  uint16_t size;                                                               /*!< struct size in bytes */
+  uint8_t* image;                                                              /*!< last committed struct, size bytes of ram */
+} ee_struct_type;
+#endif
+
+FMC_STATUS_T flash_ee_init       (void);
+FMC_STATUS_T flash_ee_init_start (void);
+FMC_STATUS_T flash_ee_init_service(void);
+FMC_STATUS_T flash_ee_init_finish(void);
+#if (EE_THREAD_SAFE > 0)
+void              flash_ee_lock_register(void (*lock)(void), void (*unlock)(void));
+#endif
+uint16_t          flash_ee_data_read  (uint16_t address, uint16_t* pdata);
+FMC_STATUS_T flash_ee_data_write (uint16_t address, uint16_t data);
+FMC_STATUS_T flash_ee_partition_init(ee_partition_type* partition, uint32_t base_address, uint16_t sector_num, uint16_t address_min, uint16_t address_max);
+uint16_t          flash_ee_partition_read(ee_partition_type* partition, uint16_t address, uint16_t* pdata);
+FMC_STATUS_T flash_ee_partition_write(ee_partition_type* partition, uint16_t address, uint16_t data);
+#if (EE_RECORD_INVALIDATE > 0)
+uint16_t          flash_ee_partition_usage(ee_partition_type* partition, uint16_t* plive, uint16_t* pdead);
+#endif
+#if (EE_COUNTER_TICKS > 0)
+FMC_STATUS_T flash_ee_counter_increment(uint16_t address);
+FMC_STATUS_T flash_ee_partition_counter_increment(ee_partition_type* partition, uint16_t address);
+#endif
+uint16_t          flash_ee_read_all   (uint16_t* values, uint8_t* present, uint16_t count);
+void              flash_ee_iterator_init(ee_iterator_type* iterator);
+uint16_t          flash_ee_iterator_next(ee_iterator_type* iterator, uint16_t* paddress, uint16_t* pdata);
+#if (EE_GROUP_COMMIT > 0)
+FMC_STATUS_T flash_ee_struct_register(ee_struct_type* layout, const ee_field_type* fields, uint16_t field_num, void* image, uint16_t size);
+FMC_STATUS_T flash_ee_struct_load(ee_struct_type* layout, void* data);
+FMC_STATUS_T flash_ee_struct_save(ee_struct_type* layout, const void* data);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+
+
+
+
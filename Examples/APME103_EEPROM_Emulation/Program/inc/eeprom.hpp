@@ -0,0 +1,207 @@
+/**
+  **************************************************************************
+  * @file     eeprom.hpp
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom compile-time c++ configuration layer
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_HPP
+#define __EEPROM_HPP
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  header only facade over the c emulator, c++11. the page geometry is a template
+  argument: the layout constants and record offsets are constant expressions and an
+  invalid geometry fails to compile. every call forwards to the c functions inline.
+
+    typedef ee::EepromEmulator<ee::FmcBackend, EE_PAGE_SIZE, 2, 64> settings;
+
+    settings::init();
+    settings::write<SPEED_KEY>(speed);              key checked by static_assert
+    settings::read(key, speed);                     key checked at run time
+
+  with CheckKeys false the run time key check is removed. with BaseAddress 0 the
+  facade drives the default eeprom at EE_BASE_ADDRESS, otherwise a partition of its own.
+*/
+
+namespace ee
+{
+
+/**
+  * @brief  storage backends, the c layer is built for the one selected by EE_BACKEND.
+  */
+struct FmcBackend
+{
+  static const uint16_t id          = EE_BACKEND_FMC;                          /*!< EE_BACKEND value */
+  static const uint32_t sector_size = FMC_PAGE_SIZE;                          /*!< erase unit */
+};
+
+#if (EE_BACKEND != EE_BACKEND_FMC)
+struct NorBackend
+{
+  static const uint16_t id          = EE_BACKEND_NOR;                          /*!< EE_BACKEND value */
+  static const uint32_t sector_size = EE_NOR_SECTOR_SIZE;                      /*!< erase unit */
+};
+
+struct SramBackend
+{
+  static const uint16_t id          = EE_BACKEND_SRAM;                         /*!< EE_BACKEND value */
+  static const uint32_t sector_size = EE_NOR_SECTOR_SIZE;                      /*!< erase unit */
+};
+#endif
+
+/**
+  * @brief  flash eeprom of a compile-time geometry.
+  * @param  Backend: storage backend.
+  * @param  PageSize: page size in bytes, a multiple of the backend sector size.
+  * @param  PageCount: pages the emulator alternates, a page pair.
+  * @param  MaxKeys: number of keys, from EE_ADDRESS_MIN on.
+  * @param  BaseAddress: page 0 address, 0 for the default eeprom.
+  * @param  CheckKeys: check run time keys against the layout.
+  */
+template <typename Backend, uint32_t PageSize, uint16_t PageCount, uint16_t MaxKeys,
+          uint32_t BaseAddress = 0, bool CheckKeys = true>
+class EepromEmulator
+{
+public:
+  static const uint32_t page_size    = PageSize;                               /*!< page size */
+  static const uint16_t page_count   = PageCount;                              /*!< pages of the pair */
+  static const uint16_t sector_num   = (uint16_t)(PageSize / Backend::sector_size); /*!< sectors per page */
+  static const uint16_t slot_num     = (uint16_t)(PageSize / 4);               /*!< record slots per page, slot 0 is the header */
+  static const uint16_t key_min      = EE_ADDRESS_MIN;                         /*!< lowest key */
+  static const uint16_t key_max      = (uint16_t)(EE_ADDRESS_MIN + MaxKeys - 1); /*!< highest key */
+  static const uint32_t base_address = BaseAddress;                            /*!< page 0 address, 0 for the default eeprom */
+
+  static_assert(Backend::id == EE_BACKEND, "the c layer is built for another EE_BACKEND");
+  static_assert(PageCount == 2, "the emulator alternates a page pair");
+  static_assert((PageSize >= Backend::sector_size) && (PageSize % Backend::sector_size == 0), "a page is a whole number of sectors");
+  static_assert(PageSize < 0x40000, "record slots are numbered with 16 bits, which limits a page to 256K");
+  static_assert(BaseAddress % Backend::sector_size == 0, "the page pair must be sector aligned");
+  static_assert((BaseAddress != 0) || (PageSize == EE_PAGE_SIZE), "the default eeprom uses EE_SECTOR_NUM sectors per page");
+  static_assert((MaxKeys > 0) && (MaxKeys < PageSize / 4), "every key needs a record slot of a page");
+  static_assert((uint32_t)EE_ADDRESS_MIN + MaxKeys - 1 <= EE_ADDRESS_MAX, "keys beyond EE_ADDRESS_MAX");
+
+  /**
+    * @brief  address of a page of the pair, BaseAddress only.
+    */
+  static constexpr uint32_t page_address(uint16_t page)
+  {
+    return BaseAddress + page * PageSize;
+  }
+
+  /**
+    * @brief  offsets of the data and the key halfword of a record slot in its page.
+    */
+  static constexpr uint32_t data_offset(uint16_t slot)
+  {
+    return (uint32_t)slot * 4;
+  }
+
+  static constexpr uint32_t key_offset(uint16_t slot)
+  {
+    return (uint32_t)slot * 4 + 2;
+  }
+
+  /**
+    * @brief  check a key against the layout.
+    */
+  static constexpr bool valid_key(uint16_t key)
+  {
+    return (key >= key_min) && (key <= key_max);
+  }
+
+  /**
+    * @brief  bring the page pair into a valid state.
+    */
+  static FMC_STATUS_T init()
+  {
+    return (BaseAddress == 0) ? flash_ee_init() :
+           flash_ee_partition_init(&partition, BaseAddress, sector_num, key_min, key_max);
+  }
+
+  /**
+    * @brief  read a key, 0 when the data is read.
+    */
+  static uint16_t read(uint16_t key, uint16_t& data)
+  {
+    if (CheckKeys && !valid_key(key))
+    {
+      return 1;
+    }
+
+    return raw_read(key, data);
+  }
+
+  template <uint16_t Key>
+  static uint16_t read(uint16_t& data)
+  {
+    static_assert(valid_key(Key), "key outside the layout");
+
+    return raw_read(Key, data);
+  }
+
+  /**
+    * @brief  write a key.
+    */
+  static FMC_STATUS_T write(uint16_t key, uint16_t data)
+  {
+    if (CheckKeys && !valid_key(key))
+    {
+      return FMC_STATUS_ERROR_PG;
+    }
+
+    return raw_write(key, data);
+  }
+
+  template <uint16_t Key>
+  static FMC_STATUS_T write(uint16_t data)
+  {
+    static_assert(valid_key(Key), "key outside the layout");
+
+    return raw_write(Key, data);
+  }
+
+#if (EE_COUNTER_TICKS > 0)
+  /**
+    * @brief  increment a counter key.
+    */
+  template <uint16_t Key>
+  static FMC_STATUS_T increment()
+  {
+    static_assert(valid_key(Key), "key outside the layout");
+
+    return (BaseAddress == 0) ? flash_ee_counter_increment(Key) :
+           flash_ee_partition_counter_increment(&partition, Key);
+  }
+#endif
+
+private:
+  static ee_partition_type partition;                                          /*!< page pair of a facade with a BaseAddress */
+
+  static uint16_t raw_read(uint16_t key, uint16_t& data)
+  {
+    return (BaseAddress == 0) ? flash_ee_data_read(key, &data) :
+           flash_ee_partition_read(&partition, key, &data);
+  }
+
+  static FMC_STATUS_T raw_write(uint16_t key, uint16_t data)
+  {
+    return (BaseAddress == 0) ? flash_ee_data_write(key, data) :
+           flash_ee_partition_write(&partition, key, data);
+  }
+};
+
+template <typename Backend, uint32_t PageSize, uint16_t PageCount, uint16_t MaxKeys, uint32_t BaseAddress, bool CheckKeys>
+ee_partition_type EepromEmulator<Backend, PageSize, PageCount, MaxKeys, BaseAddress, CheckKeys>::partition;
+
+} /* namespace ee */
+
+#endif
@@ -0,0 +1,100 @@
+/**
+  **************************************************************************
+  * @file     eeprom_log.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom append only log header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_LOG_H
+#define __EEPROM_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  a log partition is a ring of sectors for events and snapshots that are never
+  overwritten. entries are appended at a cached head, no key is looked up and nothing
+  is copied: when the head wraps onto the oldest sector, that sector is erased and its
+  entries are dropped.
+
+  +--------+-------+-------+-----+--------+
+  | header | entry | entry | ... | erased |
+  +--------+-------+-------+-----+--------+
+
+  header: sequence low, sequence high, reserved, EE_LOG_PAGE_MARK
+  entry:  length, timestamp low, timestamp high, data ..., EE_LOG_COMMIT
+
+  the header holds the sequence number of the first entry of the sector, the entries
+  after it count up from there. an entry is programmed in order with its commit
+  halfword last, an entry cut by a reset keeps its length so that it is stepped over,
+  and its sequence number is skipped. sequence numbers increase but may have gaps.
+  timestamps are given by the caller and must not decrease for flash_ee_log_seek_time.
+*/
+
+/*!< user defined */
+#define EE_LOG_PAGE_NUM          4                                             /*!< sectors of the log ring of the example, 2 at least */
+
+/*!< user do not need to care */
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#define EE_LOG_BASE_ADDRESS      ((uint32_t)(((EE_HOT_KEYS > 0) ? EE_HOT_BASE_ADDRESS : EE_BASE_ADDRESS) - \
+                                  EE_SECTOR_SIZE * EE_LOG_PAGE_NUM))           /*!< log ring, just below the eeprom page pairs */
+#else
+#define EE_LOG_BASE_ADDRESS      ((uint32_t)(EE_BASE_ADDRESS + EE_PAGE_SIZE * ((EE_HOT_KEYS > 0) ? 4 : 2))) /*!< log ring, just above the eeprom page pairs */
+#endif
+
+#define EE_LOG_PAGE_MARK         ((uint16_t)0x4C47)                            /*!< last header halfword of an opened sector */
+#define EE_LOG_COMMIT            ((uint16_t)0x0000)                            /*!< last halfword of a complete entry */
+#define EE_LOG_HEADER_SIZE       ((uint32_t)8)                                 /*!< sector header bytes */
+#define EE_LOG_ENTRY_SIZE(size)  ((uint32_t)8 + (((uint32_t)(size) + 1) & ~(uint32_t)1)) /*!< flash bytes of an entry of size data bytes */
+
+/**
+  * @brief  flash eeprom log partition, a ring of page_num sectors. the head is found once
+  *         by flash_ee_log_init and kept in ram.
+  */
+typedef struct
+{
+  uint32_t base_address;                                                       /*!< sector 0 address, the sectors follow it */
+  uint32_t page_size;                                                          /*!< sector size, the erase unit of the backend */
+  uint16_t page_num;                                                           /*!< sectors of the ring */
+  uint16_t entry_size;                                                         /*!< data bytes of every entry, 0 for variable size entries */
+  uint16_t head_page;                                                          /*!< sector the entries are appended to */
+  uint16_t tail_page;                                                          /*!< oldest sector */
+  uint32_t head_offset;                                                        /*!< first free byte of the head sector */
+  uint32_t last_address;                                                       /*!< newest complete entry, 0 when there is none */
+  uint32_t last_seq;                                                           /*!< sequence number of the newest complete entry */
+  uint32_t next_seq;                                                           /*!< sequence number of the next entry */
+} ee_log_type;
+
+/**
+  * @brief  flash eeprom log read cursor. a cursor whose sector is reclaimed by later
+  *         appends moves on to the oldest entry left.
+  */
+typedef struct
+{
+  uint16_t page;                                                               /*!< sector of the next entry */
+  uint32_t offset;                                                             /*!< offset of the next entry in the sector */
+  uint32_t seq;                                                                /*!< sequence number of the next entry */
+} ee_log_cursor_type;
+
+FMC_STATUS_T flash_ee_log_init     (ee_log_type* log, uint32_t base_address, uint16_t page_num, uint16_t entry_size);
+FMC_STATUS_T flash_ee_log_append   (ee_log_type* log, uint32_t timestamp, const void* data, uint16_t size);
+uint16_t          flash_ee_log_tail (ee_log_type* log, uint32_t* pseq, uint32_t* ptimestamp, void* data, uint16_t size, uint16_t* plength);
+uint16_t          flash_ee_log_seek (ee_log_type* log, ee_log_cursor_type* cursor, uint32_t seq);
+uint16_t          flash_ee_log_seek_time(ee_log_type* log, ee_log_cursor_type* cursor, uint32_t timestamp);
+uint16_t          flash_ee_log_next (ee_log_type* log, ee_log_cursor_type* cursor, uint32_t* pseq, uint32_t* ptimestamp, void* data, uint16_t size, uint16_t* plength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
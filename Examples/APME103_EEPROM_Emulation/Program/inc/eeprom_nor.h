@@ -0,0 +1,63 @@
+/**
+  **************************************************************************
+  * @file     eeprom_nor.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom external NOR/SRAM backend header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_NOR_H
+#define __EEPROM_NOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "apm32e10x_emmc.h"
+
+/*
+  the external memory is mapped by the EMMC at the bank 1 NOR/SRAM region, reads are
+  plain memory loads. NOR flash is programmed and erased with the CFI/AMD command set
+  (16-bit device), SRAM is written directly and "erased" by filling it with 0xFFFF so
+  that the emulator sees the same state machine as on internal flash.
+*/
+
+/*!< user defined */
+#define EE_NOR_BANK              EMMC_BANK1_NORSRAM_1                          /*!< EMMC bank 1 region the device is wired to (NE1) */
+#define EE_NOR_BANK_ADDRESS      ((uint32_t)0x60000000)                        /*!< base address of the selected region */
+#define EE_NOR_OFFSET            ((uint32_t)0x00000000)                        /*!< offset of the eeprom area inside the device */
+#define EE_NOR_SECTOR_SIZE       ((uint32_t)(1024 * 64))                       /*!< erase sector size of the device */
+
+#define EE_NOR_PROGRAM_TIMEOUT   ((uint32_t)0x00004000)                        /*!< halfword program polling timeout */
+#define EE_NOR_ERASE_TIMEOUT     ((uint32_t)0x00A00000)                        /*!< sector erase polling timeout */
+
+/*!< user do not need to care, the backend reaches the device through these bus cycles, a
+     host model of the device (Tools/ee_cfi.h) defines them to take the cycles over */
+#ifndef EE_NOR_WRITE
+#define EE_NOR_WRITE(address, data) ((*(__IO uint16_t *)(address)) = (data))  /*!< halfword write cycle */
+#define EE_NOR_READ(address)     (*(__IO uint16_t *)(address))                 /*!< halfword read cycle */
+#endif
+
+#define EE_NOR_COMMAND(x, data)  EE_NOR_WRITE(EE_NOR_BANK_ADDRESS + ((x) << 1), data) /*!< command cycle, 16-bit bus */
+
+void              flash_ee_nor_init           (void);
+void              flash_ee_nor_unlock         (void);
+void              flash_ee_nor_lock           (void);
+void              flash_ee_nor_reset          (void);
+FMC_STATUS_T flash_ee_nor_halfword_program(uint32_t address, uint16_t data);
+FMC_STATUS_T flash_ee_nor_buffer_program(uint32_t address, const uint16_t* data, uint32_t count);
+FMC_STATUS_T flash_ee_nor_sector_erase    (uint32_t address);
+FMC_STATUS_T flash_ee_nor_range_erase(uint32_t address, uint32_t count, uint32_t* fail_address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/**
+  **************************************************************************
+  * @file     eeprom_queue.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom interrupt write queue header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_QUEUE_H
+#define __EEPROM_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  a write may transfer a page and wait for its erase, so it cannot run in an interrupt.
+  an interrupt hands its writes to a queue instead: flash_ee_queue_put stores the
+  variable address and data as one word of a ram ring and returns, without lock, loop or
+  flash access. flash_ee_queue_flush writes the queued variables from thread context, in
+  the order they were put.
+
+  +-------+-------+-----+-------+
+  | entry | entry | ... | entry |     entry: variable address << 16 | data
+  +-------+-------+-----+-------+
+      ^ tail, flush         ^ head, put
+
+  a queue has one producer: the interrupts that put to it must not preempt each other,
+  an interrupt of another priority takes a queue of its own. a full queue either drops
+  its oldest entry or, for a variable already waiting, overwrites the data of its newest
+  entry, see ee_queue_policy_type.
+*/
+
+/*!< user defined */
+#define EE_QUEUE_SIZE            16                                            /*!< entries of the queue of the example, a power of 2 */
+
+/**
+  * @brief  flash eeprom queue overflow policy
+  */
+typedef enum
+{
+  EE_QUEUE_DROP_OLDEST              = 0x00, /*!< a put to a full queue drops the oldest entry */
+  EE_QUEUE_COALESCE                 = 0x01, /*!< a put to a full queue overwrites the newest entry of its variable,
+                                                 the oldest entry is dropped when the variable is not waiting */
+} ee_queue_policy_type;
+
+/**
+  * @brief  flash eeprom queue put status
+  */
+typedef enum
+{
+  EE_QUEUE_QUEUED                   = 0x00, /*!< the write is queued */
+  EE_QUEUE_COALESCED                = 0x01, /*!< the write replaced the data of a waiting write of its variable */
+  EE_QUEUE_DROPPED                  = 0x02, /*!< the write is queued, the oldest entry was dropped */
+} ee_queue_status_type;
+
+/**
+  * @brief  flash eeprom write queue. head and the producer counters are changed by the
+  *         producer only, tail and the flush counters by the flush only.
+  */
+typedef struct
+{
+  uint32_t* buffer;                                                            /*!< ring of size entries */
+  uint16_t size;                                                               /*!< entries of the ring, a power of 2 */
+  ee_queue_policy_type policy;                                                 /*!< overflow policy */
+  ee_partition_type* partition;                                                /*!< partition written, NULL for the eeprom of flash_ee_init */
+  __IO uint32_t head;                                                          /*!< entries put, the next one goes to buffer[head % size] */
+  __IO uint32_t tail;                                                          /*!< entries flushed or dropped, the next one is buffer[tail % size] */
+  __IO uint16_t high_water;                                                    /*!< most entries waiting at once */
+  __IO uint32_t coalesced;                                                     /*!< writes merged into a waiting entry */
+  __IO uint32_t dropped;                                                       /*!< entries dropped unwritten */
+  __IO uint32_t failed;                                                        /*!< entries whose write failed */
+} ee_queue_type;
+
+uint16_t             flash_ee_queue_init (ee_queue_type* queue, uint32_t* buffer, uint16_t size, ee_queue_policy_type policy, ee_partition_type* partition);
+ee_queue_status_type flash_ee_queue_put  (ee_queue_type* queue, uint16_t address, uint16_t data);
+uint16_t             flash_ee_queue_depth(ee_queue_type* queue);
+FMC_STATUS_T         flash_ee_queue_flush(ee_queue_type* queue, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
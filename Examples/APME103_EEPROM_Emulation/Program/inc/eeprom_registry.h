@@ -0,0 +1,124 @@
+/**
+  **************************************************************************
+  * @file     eeprom_registry.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom typed variable registry header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_REGISTRY_H
+#define __EEPROM_REGISTRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  the persistent variables are declared once in EE_REGISTRY as X(name, type, default).
+  the list generates the ram copy ee_registry, its defaults and a struct layout: each
+  variable takes (sizeof(type) + 1) / 2 keys from EE_REGISTRY_BASE_ADDRESS on, in list
+  order, and is committed as one group. flash_ee_registry_init loads the copy in a single
+  page pass, variables never written keep their default, later reads never touch flash.
+
+    uint16_t limit;
+
+    EE_REGISTRY_READ(speed_limit, &limit);
+    EE_REGISTRY_WRITE(speed_limit, &limit);     a pointer of another type fails to compile
+
+  keys are assigned by position, so new variables are appended at the end of the list.
+  the registry needs EE_GROUP_COMMIT, without it the header declares nothing.
+*/
+
+/*!< user defined */
+#define EE_REGISTRY_BASE_ADDRESS ((uint16_t)0x0100)                            /*!< variable address of the first registry key */
+
+#define EE_REGISTRY(X)                                                                    \
+  X(boot_count,      uint32_t,  0)                                                        \
+  X(brightness,      uint8_t,   80)                                                       \
+  X(language,        uint8_t,   0)                                                        \
+  X(speed_limit,     uint16_t,  1000)                                                     \
+  X(calibration,     int16_t,   -12)
+
+/*!< user do not need to care, the registry is committed through the struct layer */
+#if (EE_GROUP_COMMIT > 0)
+
+#define EE_REGISTRY_MEMBER(name, type, value)     type name;
+#define EE_REGISTRY_KEY(name, type, value)        EE_KEY_##name, EE_KEY_##name##_LAST = EE_KEY_##name + (sizeof(type) + 1) / 2 - 1,
+
+/**
+  * @brief  ram copy of the registry variables.
+  */
+typedef struct
+{
+  EE_REGISTRY(EE_REGISTRY_MEMBER)
+} ee_registry_type;
+
+/**
+  * @brief  widest registry variable, sizes the largest group.
+  */
+typedef union
+{
+  EE_REGISTRY(EE_REGISTRY_MEMBER)
+} ee_registry_widest_type;
+
+/**
+  * @brief  variable addresses of the registry keys.
+  */
+enum
+{
+  EE_KEY_REGISTRY_FIRST = EE_REGISTRY_BASE_ADDRESS - 1,
+  EE_REGISTRY(EE_REGISTRY_KEY)
+  EE_KEY_REGISTRY_END
+};
+
+#define EE_REGISTRY_KEYS         (EE_KEY_REGISTRY_END - EE_REGISTRY_BASE_ADDRESS) /*!< keys used by the registry */
+#define EE_REGISTRY_GROUP_SLOTS  ((sizeof(ee_registry_widest_type) + 1) / 2 + 1) /*!< slots of the largest variable commit, header included */
+
+/*!< capacity checks, a failing check declares an array of negative size */
+#define EE_REGISTRY_ASSERT(name, cond)  typedef char ee_registry_assert_##name[(cond) ? 1 : -1]
+
+EE_REGISTRY_ASSERT(address_min, EE_REGISTRY_BASE_ADDRESS >= EE_ADDRESS_MIN);
+EE_REGISTRY_ASSERT(address_max, EE_KEY_REGISTRY_END - 1 <= EE_ADDRESS_MAX);
+EE_REGISTRY_ASSERT(page_size,   EE_REGISTRY_KEYS + EE_REGISTRY_GROUP_SLOTS <= EE_PARA_MAX_NUMBER);
+#if (EE_PACKED_KEYS > 0)
+EE_REGISTRY_ASSERT(packed_keys, (EE_KEY_REGISTRY_END <= EE_PACKED_BASE_ADDRESS) ||
+                                (EE_REGISTRY_BASE_ADDRESS >= EE_PACKED_BASE_ADDRESS + EE_PACKED_KEYS));
+#endif
+#if (EE_INDEX_BITS > 0)
+EE_REGISTRY_ASSERT(index_size,  EE_REGISTRY_KEYS < EE_INDEX_SIZE);
+#endif
+
+/*!< typed access, checked at compile time: a pointer to another type declares an array
+     of negative size, compilers without the gnu type builtins only check the size */
+#if defined(__GNUC__)
+#define EE_REGISTRY_SAME_TYPE(name, pdata) \
+  __builtin_types_compatible_p(__typeof__(*(pdata)), __typeof__(ee_registry.name))
+#else
+#define EE_REGISTRY_SAME_TYPE(name, pdata) (sizeof(*(pdata)) == sizeof(ee_registry.name))
+#endif
+
+#define EE_REGISTRY_CHECK(name, pdata) ((void)sizeof(char[EE_REGISTRY_SAME_TYPE(name, pdata) ? 1 : -1]))
+
+#define EE_REGISTRY_READ(name, pdata)  (EE_REGISTRY_CHECK(name, pdata), (void)(*(pdata) = ee_registry.name))
+#define EE_REGISTRY_WRITE(name, pdata) (EE_REGISTRY_CHECK(name, pdata), ee_registry.name = *(pdata), flash_ee_registry_commit())
+
+extern ee_registry_type ee_registry;
+
+FMC_STATUS_T flash_ee_registry_init  (void);
+FMC_STATUS_T flash_ee_registry_commit(void);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+/**
+  **************************************************************************
+  * @file     eeprom_settings.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    example settings of the flash eeprom header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_SETTINGS_H
+#define __EEPROM_SETTINGS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  the example keys of main.c, EE_SETTINGS_KEYS keys from EE_ADDRESS_MIN on in the
+  default eeprom. eeprom_settings.cpp accesses them through the c++ facade of
+  eeprom.hpp, the c code calls the functions below.
+*/
+
+/*!< user defined */
+#define EE_SETTINGS_KEYS         10                                            /*!< number of example keys */
+
+FMC_STATUS_T flash_ee_settings_save(const uint16_t* values);
+uint16_t          flash_ee_settings_load(uint16_t* values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,168 @@
+/**
+  **************************************************************************
+  * @file     eeprom_trace.h
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    flash eeprom operation trace header file
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+/*!< define to prevent recursive inclusion -------------------------------------*/
+#ifndef __EEPROM_TRACE_H
+#define __EEPROM_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* includes ------------------------------------------------------------------*/
+#include "eeprom.h"
+
+/*
+  with EE_TRACE_EVENTS enabled the emulator keeps its last EE_TRACE_EVENTS operations in a
+  ram ring, the oldest event is overwritten. flash_ee_trace_dump_start sends the ring out
+  as one frame by dma through the board usart, the recording pauses until the frame is
+  sent and counts the events it misses. Tools/ee_trace_decode.c turns a frame into a
+  timeline.
+
+  frame: magic, entry size, entries, events recorded, events missed, entries ...
+  entry: timestamp, event, status, key, argument, 12 bytes little endian
+
+  the timestamps come from the clock given to flash_ee_trace_init, by default from the
+  cpu cycle counter.
+
+  with EE_CAPTURE_BYTES enabled the writes of the eeprom of flash_ee_init are captured
+  for the replay of Tools/ee_replay.c. a record is the time since the previous one and
+  the kind as one varint, then the variable address and the data, 5 bytes for writes a
+  few milliseconds apart. a full buffer is handed to flash_ee_capture_service, which
+  sends it while the other one fills; records that find both buffers taken are missed.
+
+  capture frame: magic, bytes, records, clock rate, first timestamp, sequence, missed, records ...
+  record: varint (ticks << 2 | kind), variable address, data (not for increments)
+*/
+
+/*!< user defined */
+#define EE_TRACE_USART           MINI_COM1                                     /*!< usart the frame is sent on, set up by APM_MINI_COMInit */
+#define EE_TRACE_DMA_CHANNEL     DMA1_Channel4                                 /*!< dma channel of the usart transmit request */
+#define EE_TRACE_DMA_FLAG_TC     DMA1_FLAG_TC4                                 /*!< transfer complete flag of the channel */
+
+/*!< user do not need to care */
+#define EE_TRACE_MAGIC           ((uint32_t)0x52544545)                        /*!< "EETR", first word of a frame */
+#define EE_CAPTURE_MAGIC         ((uint32_t)0x50434545)                        /*!< "EECP", first word of a capture frame */
+
+/**
+  * @brief  flash eeprom trace event
+  */
+typedef enum
+{
+  EE_TRACE_WRITE                    = 0x01, /*!< key: variable address, argument: data */
+  EE_TRACE_ELIDED                   = 0x02, /*!< write skipped, key: variable address, argument: data or halfwords skipped */
+  EE_TRACE_INCREMENT                = 0x03, /*!< counter increment, key: variable address */
+  EE_TRACE_GROUP                    = 0x04, /*!< struct save, key: first variable address, argument: halfwords written */
+  EE_TRACE_TRANSFER                 = 0x05, /*!< page transfer started, argument: full page address */
+  EE_TRACE_TRANSFER_END             = 0x06, /*!< page transfer done, key: records copied, argument: new page address */
+  EE_TRACE_ERASE                    = 0x07, /*!< page erase, key: sectors, argument: page address */
+  EE_TRACE_RECOVER                  = 0x08, /*!< recovery action started, key: ee_trace_action_type, argument: page 0 address */
+  EE_TRACE_FMC_ERROR                = 0x09, /*!< failed program or erase, key: FMC status flags, argument: flash address */
+} ee_trace_event_type;
+
+/**
+  * @brief  flash eeprom trace recovery action
+  */
+typedef enum
+{
+  EE_TRACE_FORMAT                   = 0x01, /*!< page pair in no valid state formatted */
+  EE_TRACE_MARK_VALID               = 0x02, /*!< finished transfer marked VALID */
+  EE_TRACE_RESUME                   = 0x03, /*!< interrupted transfer copied again */
+  EE_TRACE_ROLLBACK                 = 0x04, /*!< interrupted group dropped */
+} ee_trace_action_type;
+
+/**
+  * @brief  flash eeprom capture record kind
+  */
+typedef enum
+{
+  EE_CAPTURE_WRITE                  = 0x00, /*!< variable write */
+  EE_CAPTURE_INCREMENT              = 0x01, /*!< counter increment, no data */
+  EE_CAPTURE_GROUP                  = 0x02, /*!< struct save, data: halfwords written, their writes follow */
+} ee_capture_kind_type;
+
+/**
+  * @brief  flash eeprom trace entry
+  */
+typedef struct
+{
+  uint32_t timestamp;                                                          /*!< clock of flash_ee_trace_init */
+  uint8_t  event;                                                              /*!< ee_trace_event_type */
+  uint8_t  status;                                                             /*!< flash status, 0 when none */
+  uint16_t key;                                                                /*!< event key */
+  uint32_t argument;                                                           /*!< event argument */
+} ee_trace_entry_type;
+
+#if (EE_TRACE_EVENTS > 0)
+/**
+  * @brief  flash eeprom trace frame, sent as it is in ram.
+  */
+typedef struct
+{
+  uint32_t magic;                                                              /*!< EE_TRACE_MAGIC */
+  uint16_t entry_size;                                                         /*!< sizeof(ee_trace_entry_type) */
+  uint16_t entry_num;                                                          /*!< EE_TRACE_EVENTS */
+  uint32_t head;                                                               /*!< events recorded, the next one goes to entry[head % entry_num] */
+  uint32_t missed;                                                             /*!< events not recorded while a frame was sent */
+  ee_trace_entry_type entry[EE_TRACE_EVENTS];
+} ee_trace_frame_type;
+
+void         flash_ee_trace_init      (uint32_t (*clock)(void));
+void         flash_ee_trace_record    (ee_trace_event_type event, uint8_t status, uint16_t key, uint32_t argument);
+FMC_STATUS_T flash_ee_trace_check     (FMC_STATUS_T flash_status, uint32_t address);
+uint16_t     flash_ee_trace_dump_start(void);
+uint16_t     flash_ee_trace_dump_busy (void);
+
+#define ee_trace(event, status, key, argument) flash_ee_trace_record(event, (uint8_t)(status), (uint16_t)(key), (uint32_t)(argument))
+#define ee_traced(flash_status, address)       flash_ee_trace_check(flash_status, address)
+#else
+#define ee_trace(event, status, key, argument)
+#define ee_traced(flash_status, address)       (flash_status)
+#endif
+
+#if (EE_CAPTURE_BYTES > 0)
+/**
+  * @brief  flash eeprom capture frame, sent as it is in ram up to the used bytes.
+  */
+typedef struct
+{
+  uint32_t magic;                                                              /*!< EE_CAPTURE_MAGIC */
+  uint16_t size;                                                               /*!< bytes of records */
+  uint16_t records;                                                            /*!< records of the frame */
+  uint32_t clock_hz;                                                           /*!< rate of the capture clock */
+  uint32_t start;                                                              /*!< timestamp the first record counts from */
+  uint32_t sequence;                                                           /*!< frames filled before this one */
+  uint32_t missed;                                                             /*!< records missed from the capture start to the frame end */
+  uint8_t  data[EE_CAPTURE_BYTES];
+} ee_capture_frame_type;
+
+void     flash_ee_capture_init   (uint32_t (*clock)(void), uint32_t clock_hz);
+void     flash_ee_capture_record (ee_capture_kind_type kind, uint16_t address, uint16_t data);
+void     flash_ee_capture_flush  (void);
+uint16_t flash_ee_capture_service(void);
+
+#define ee_capture(kind, address, data)        flash_ee_capture_record(kind, address, data)
+#else
+#define ee_capture(kind, address, data)
+#endif
+
+#if (EE_TRACE_EVENTS > 0) || (EE_CAPTURE_BYTES > 0)
+uint32_t     flash_ee_trace_cycles    (void);
+uint16_t     flash_ee_trace_send      (const void* frame, uint32_t size);
+uint16_t     flash_ee_trace_send_busy (void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,618 +1,3608 @@
-/**
-  **************************************************************************
-  * @file     eeprom.c
-  * @version  v1.0.0
-  * @date     2022-08-15
-  * @brief    the driver library of the flash eeprom
-  **************************************************************************
-
-  *
-  **************************************************************************
-  */
-  
-#include "eeprom.h"
-
-#define EE_VALID_PAGE0                  ((uint16_t)0x0000)  /*!< the effective page is page 0 */ 
-#define EE_VALID_PAGE1                  ((uint16_t)0x0001)  /*!< the effective page is page 1 */ 
-#define EE_VALID_PAGE_NONE              ((uint16_t)0x0002)  /*!< no valid page found */
-                                                              
-#define EE_PAGE_ERASED                  ((uint16_t)0xFFFF)  /*!< page is in erased state */ 
-#define EE_PAGE_TRANSFER                ((uint16_t)0xCCCC)  /*!< page is in transfer state */ 
-#define EE_PAGE_VALID                   ((uint16_t)0x0000)  /*!< page is in valid state */ 
-
-/**
-  * @brief  flash eeprom valid page get mode
-  */
-typedef enum
-{
-  EE_VALID_PAGE_READ                = 0x01, /*!< get valid page in read mode */
-  EE_VALID_PAGE_WRITE               = 0x02, /*!< get valid page in write mode */
-} ee_valid_page_type;
-
-/** 
-  * @brief  erase eeprom page, one page can contain one or more sectors.
-  * @param  page_address:
-  *         this parameter can be one of the following values:  
-  *         - EE_PAGE0_ADDRESS: erase page 0
-  *         - EE_PAGE1_ADDRESS: erase page 1
-  * @retval FMC_STATUS_T
-  */
-FMC_STATUS_T flash_ee_page_erase(uint32_t page_address)
-{
-  uint16_t i;
-  uint32_t erase_address;
-  FMC_STATUS_T flash_status;
-  
-  /* erase one or more sectors */ 
-  for(i = 0; i < EE_SECTOR_NUM; i++)
-  {
-    /* calculate the erase address */ 
-    erase_address = page_address + i * EE_SECTOR_SIZE;
-    
-    /* erase sector */ 
-    if ((flash_status = FMC_ErasePage(erase_address)) != FMC_STATUS_COMPLETE)
-    {
-      return flash_status;
-    }
-  }
-  
-  return FMC_STATUS_COMPLETE;  
-}
-
-/** 
-  * @brief  get the valid eeprom page.
-  * @param  mode
-  *         - EE_VALID_PAGE_READ: get valid page in read mode 
-  *         - EE_VALID_PAGE_WRITE: get valid page in write mode
-  * @retval valid page
-  *         - EE_VALID_PAGE0: page 0 is valid
-  *         - EE_VALID_PAGE1: page 1 is valid
-  *         - EE_VALID_PAGE_NONE: no valid page
-  */
-uint16_t flash_ee_valid_page_get(ee_valid_page_type mode)
-{
-  uint16_t page0_status;
-  uint16_t page1_status;
-
-  /* get page 0 status */ 
-  page0_status = (*(__IO uint16_t*)EE_PAGE0_ADDRESS);
-
-  /* get page 1 status */ 
-  page1_status = (*(__IO uint16_t*)EE_PAGE1_ADDRESS);
-
-  if (mode == EE_VALID_PAGE_READ)
-  {
-    if (page0_status == EE_PAGE_VALID)
-    {
-      /* page 0 is valid */ 
-      return EE_VALID_PAGE0;
-    }
-    else if (page1_status == EE_PAGE_VALID)
-    {
-      /* page 1 is valid */     
-      return EE_VALID_PAGE1;     
-    }  
-  }
-  else
-  {
-    if (page0_status == EE_PAGE_TRANSFER)
-    {
-      /* page 0 is valid */ 
-      return EE_VALID_PAGE0;
-    }
-    else if (page1_status == EE_PAGE_TRANSFER)
-    {
-      /* page 1 is valid */ 
-      return EE_VALID_PAGE1;
-    }
-    else if (page0_status == EE_PAGE_VALID)
-    {
-      /* page 0 is valid */ 
-      return EE_VALID_PAGE0;
-    }
-    else if (page1_status == EE_PAGE_VALID)
-    {
-      /* page 1 is valid */     
-      return EE_VALID_PAGE1;     
-    }  
-  }
-
-  /* no valid page found */
-  return EE_VALID_PAGE_NONE; 
-}
-
-/** 
-  * @brief  write data to the eeprom.
-  * @param  address: variable address.
-  * @param  data: data.
-  * @retval flash_status.
-  */
-FMC_STATUS_T flash_ee_write_no_check(uint16_t address, uint16_t data)
-{
-  uint16_t valid_page;
-  uint32_t find_address; 
-  uint32_t end_address;
-  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
-  
-  /* get the valid page */
-  valid_page = flash_ee_valid_page_get(EE_VALID_PAGE_WRITE);
-
-  if (valid_page == EE_VALID_PAGE_NONE)
-  {
-    return  FMC_STATUS_ERROR_PG;
-  }
-
-  /* find address calculation */ 
-  find_address = EE_BASE_ADDRESS + valid_page * EE_PAGE_SIZE;
-
-  /* end address calculation */
-  end_address  = EE_BASE_ADDRESS + valid_page * EE_PAGE_SIZE + EE_PAGE_SIZE - 2;  
-  
-  while (find_address < end_address)
-  {
-    /* find addresses without data */ 
-    if ((*(__IO uint32_t*)find_address) == 0xFFFFFFFF)
-    {
-      /* write data to flash */ 
-      if ((flash_status = FMC_ProgramHalfWord(find_address, data)) != FMC_STATUS_COMPLETE)
-      {
-        return flash_status;
-      }
-      
-      /* write variable address to flash */
-      if ((flash_status = FMC_ProgramHalfWord(find_address + 2, address)) != FMC_STATUS_COMPLETE)
-      {
-        return flash_status;
-      }
-      
-      return FMC_STATUS_COMPLETE;
-    }
-    else
-    {
-      /* find address + 4 */ 
-      find_address += 4;
-    }
-  }
-
-  return FMC_STATUS_ERROR_PG;
-}
-
-/** 
-  * @brief  transfer full page data to empty page.
-  * @param  none
-  * @retval flash_status
-  */
-FMC_STATUS_T flash_ee_copy_to_new_page(void)
-{
-  uint16_t data;
-  uint16_t idx, valid_page;
-  uint32_t full_page_address;
-  uint32_t empty_page_address;
-  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
-  
-  /* get valid page */
-  valid_page = flash_ee_valid_page_get(EE_VALID_PAGE_READ);
-
-  if (valid_page == EE_VALID_PAGE0) 
-  {
-    /* empty page is page 1 */
-    empty_page_address = EE_PAGE1_ADDRESS;
-
-    /* full page is pgae 0 */ 
-    full_page_address = EE_PAGE0_ADDRESS;
-  }
-  else if (valid_page == EE_VALID_PAGE1) 
-  {
-    /* empty page is page 0 */
-    empty_page_address = EE_PAGE0_ADDRESS;
-
-    /* full page is pgae 1 */
-    full_page_address = EE_PAGE1_ADDRESS;
-  }
-  else
-  {
-    /* page status flag error */ 
-    return FMC_STATUS_ERROR_PG; 
-  }
-
-  /* change the status of the empty page to TRANSFER */ 
-  if ((flash_status = FMC_ProgramHalfWord(empty_page_address, EE_PAGE_TRANSFER)) != FMC_STATUS_COMPLETE)
-  {
-    return flash_status;
-  }
-
-  for (idx = 0; idx < EE_PARA_MAX_NUMBER; idx++)
-  {
-    /* find valid variables */
-    if (flash_ee_data_read(idx, &data) == 0)
-    {
-      /* store variable to new page  */ 
-      if ((flash_status = flash_ee_write_no_check(idx, data)) != FMC_STATUS_COMPLETE)
-      {
-        return flash_status;
-      }
-    }
-  }
-
-  /* erase old page */
-  if ((flash_status = flash_ee_page_erase(full_page_address)) != FMC_STATUS_COMPLETE)
-  {
-    return flash_status;
-  }
-
-  /* change the status of the empty page to VALID */ 
-  if ((flash_status = FMC_ProgramHalfWord(empty_page_address, EE_PAGE_VALID)) != FMC_STATUS_COMPLETE)
-  {
-    return flash_status;
-  }
-
-  return FMC_STATUS_COMPLETE;
-}
-
-/** 
-  * @brief  erase all pages to format eeprom.
-  * @param  none
-  * @retval flash_status
-  */
-FMC_STATUS_T flash_ee_format(void)
-{
-  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
-
-  /* erase page 0 */
-  if ((flash_status = flash_ee_page_erase(EE_PAGE0_ADDRESS)) != FMC_STATUS_COMPLETE)
-  {
-    return flash_status;
-  }
-
-  /* erase page 1 */
-  if ((flash_status = flash_ee_page_erase(EE_PAGE1_ADDRESS)) != FMC_STATUS_COMPLETE)
-  {
-    return flash_status;
-  }
-  
-  /* mark the status of page 0 as VALID */
-  return FMC_ProgramHalfWord(EE_PAGE0_ADDRESS, EE_PAGE_VALID);
-}
-
-/** 
-  * @brief  eeprom format validity check.
-  * @param  page0_status: page0 status
-  * @param  page1_status: page1 status
-  * @retval format status:
-  *         - 0: the format is correct
-  *         - 1: the format is incorrect
-  */
-uint16_t flash_ee_format_check(uint16_t page0_status, uint16_t page1_status)
-{
-  /* the euqal status is invalid */
-  if (page0_status == page1_status)
-  {
-    return 1;
-  }
-  
-  /* status is not known status is invalid status */ 
-  if ((page0_status != EE_PAGE_ERASED) && (page0_status != EE_PAGE_TRANSFER) && (page0_status != EE_PAGE_VALID))
-  {
-    return 1;
-  }
-  
-  /* status is not known status is invalid status */ 
-  if ((page1_status != EE_PAGE_ERASED) && (page1_status != EE_PAGE_TRANSFER) && (page1_status != EE_PAGE_VALID))
-  {
-    return 1;
-  }
-  
-  /* the format is correct */
-  return 0;
-}
-
-/** 
-  * @brief  check if eeprom page is full, when the page is full, transfer the data to erase page.
-  * @param  none
-  * @retval flash_status
-  */
-FMC_STATUS_T flash_ee_full_check(void)
-{
-  uint16_t valid_page;
-  uint32_t end_address;
-  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
-  
-  /* get the valid page */
-  valid_page = flash_ee_valid_page_get(EE_VALID_PAGE_READ);
-
-  if (valid_page == EE_VALID_PAGE_NONE)
-  {
-    return  FMC_STATUS_ERROR_PG;
-  }
-
-  /* end address calculation */
-  end_address  = EE_BASE_ADDRESS + valid_page * EE_PAGE_SIZE + EE_PAGE_SIZE - 2;  
-
-  /* check if the page is full */ 
-  if ((*(__IO uint32_t*)(end_address - 2)) != 0xFFFFFFFF)
-  {
-    /* when the page is full, transfer the data to erase page */ 
-    if ((flash_status = flash_ee_copy_to_new_page()) != FMC_STATUS_COMPLETE)
-    {
-      return flash_status;
-    }
-  }
-  
-  /* page full check ok */
-  return FMC_STATUS_COMPLETE;
-}
-
-/** 
-  * @brief  transition state processing, a page state is ERASE, a page state is TRANSFER, 
-  *         and the TRANSFER state is changed to VALID.
-  * @param  page0_status: page0 status
-  * @param  page1_status: page1 status
-  * @retval format status:
-  *         - 0: the format is correct
-  *         - 1: the format is incorrect
-  */
-FMC_STATUS_T flash_ee_erase_transfer(uint16_t page0_status, uint16_t page1_status)
-{
-  if (page0_status == EE_PAGE_TRANSFER)
-  {
-    /* mark the status of page 0 as VALID */
-    return FMC_ProgramHalfWord(EE_PAGE0_ADDRESS, EE_PAGE_VALID);
-  }
-  else
-  {
-    /* mark the status of page 1 as VALID */
-    return FMC_ProgramHalfWord(EE_PAGE1_ADDRESS, EE_PAGE_VALID);
-  }
-}
-
-/** 
-  * @brief  transition state processing, one page state is VALID, one page state is TRANSFER,
-  *         and the data is transferred to the TRANSFER state page.
-  * @param  page0_status: page0 status
-  * @param  page1_status: page1 status
-  * @retval format status:
-  *         - 0: the format is correct
-  *         - 1: the format is incorrect
-  */
-FMC_STATUS_T flash_ee_valid_transfer(uint16_t page0_status, uint16_t page1_status)
-{                                  
-  uint32_t erase_page_address;  
-  FMC_STATUS_T  flash_status;
-  
-  /* find the page in the transfer state, erase the page, and retransmit the data */ 
-  if (page0_status == EE_PAGE_TRANSFER)
-  {
-    erase_page_address = EE_PAGE0_ADDRESS;
-  }
-  else
-  {
-    erase_page_address = EE_PAGE1_ADDRESS;
-  }
-  
-  /* erase the transfer state page */ 
-  if ((flash_status = flash_ee_page_erase(erase_page_address)) != FMC_STATUS_COMPLETE)
-  {
-    return flash_status;
-  }
-  
-  /* retransmit data */ 
-  return flash_ee_copy_to_new_page();
-}
-
-/** 
-  * @brief  eeprom init.
-  +-------------------+---------------------------------------------------------------------------------------------+
-  |                   |                                      PAGE 1 status                                          |
-  |                   +-----------------------+----------------------------------+----------------------------------+
-  |                   |         ERASE         |              TRANSFER            |              VALID               |
-  +--------+----------+-----------------------+----------------------------------+----------------------------------+
-  |        |          |  erase page 0         |  erase page 0                    |                                  |
-  |        | ERASE    |  erase page 1         |  mark  page 1 VALID              |   erase page 0                   |
-  |        |          |  mark  page 0 VALID   |                                  |                                  |
-  |        +----------+-----------------------+----------------------------------+----------------------------------+
-  |        |          |  erase page 1         |  erase page 0                    |  erase page 0                    |
-  | PAGE 0 | TRANSFER |  mark  page 0 VALID   |  erase page 1                    |  copy data from page 1 to page 0 |
-  | status |          |                       |  mark  page 0 VALID              |  erase page 1                    |
-  |        |          |                       |                                  |  mark  page 0 VALID              |
-  |        +----------+-----------------------+----------------------------------+----------------------------------+
-  |        |          |                       |  erase page 1                    |  erase page 0                    |
-  |        | VALID    |  erase page 1         |  copy data from page 0 to page 1 |  erase page 1                    |
-  |        |          |                       |  erase page 0                    |  mark  page 0 VALID              |
-  |        |          |                       |  mark  page 1 VALID              |                                  |
-  +--------+----------+-----------------------+----------------------------------+----------------------------------+
-  * @param  none
-  * @retval flash status.
-  */
-FMC_STATUS_T flash_ee_init(void)
-{
-  uint16_t page0_status; 
-  uint16_t page1_status;
-  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
-
-  /* flash unlock */
-  FMC_Unlock();
-  
-  /* get page 0 status */ 
-  page0_status = (*(__IO uint16_t*)EE_PAGE0_ADDRESS);
-
-  /* get page 2 status */ 
-  page1_status = (*(__IO uint16_t*)EE_PAGE1_ADDRESS);
-
-  /* ensure that the sector data is completely erased */ 
-  if (page0_status == EE_PAGE_ERASED)
-  {
-    /* erase page 0 */
-    if ((flash_status = flash_ee_page_erase(EE_PAGE0_ADDRESS)) != FMC_STATUS_COMPLETE)
-    {
-      /* flash lock */
-      FMC_Lock();
-          
-      return flash_status;
-    }
-  }
-
-  /* ensure that the sector data is completely erased */ 
-  if (page1_status == EE_PAGE_ERASED)
-  {
-    /* erase page 1 */
-    if ((flash_status = flash_ee_page_erase(EE_PAGE1_ADDRESS)) != FMC_STATUS_COMPLETE)
-    {
-      /* flash lock */
-        FMC_Lock();
-      
-        return flash_status;
-    }
-  }  
-  
-  /* format validity check */
-  if (flash_ee_format_check(page0_status, page1_status) != 0)
-  {
-    /* if the format is invalid, reformat */
-    if ((flash_status = flash_ee_format()) != FMC_STATUS_COMPLETE)
-    {
-      /* flash lock */
-      FMC_Lock();
-      
-      return flash_status;
-    }
-  }
-  
-  /* transition state processing, a page state is ERASE, a page state is TRANSFER, and the TRANSFER state is changed to VALID */
-  if (((page0_status == EE_PAGE_ERASED) && (page1_status == EE_PAGE_TRANSFER)) || 
-     ((page0_status == EE_PAGE_TRANSFER) && (page1_status == EE_PAGE_ERASED)))
-  {
-    if ((flash_status = flash_ee_erase_transfer(page0_status, page1_status)) != FMC_STATUS_COMPLETE)
-    {
-      /* flash lock */
-      FMC_Lock();
-      
-      return flash_status;
-    }
-  }
-
-  /* transition state processing, one page state is VALID, one page state is TRANSFER, and the data is transferred to the TRANSFER state page */
-  if (((page0_status == EE_PAGE_VALID) && (page1_status == EE_PAGE_TRANSFER)) || 
-     ((page0_status == EE_PAGE_TRANSFER) && (page1_status == EE_PAGE_VALID)))
-  {
-    if ((flash_status = flash_ee_valid_transfer(page0_status, page1_status)) != FMC_STATUS_COMPLETE)
-    {
-      /* flash lock */
-      FMC_Lock();
-      
-      return flash_status;
-    }
-  }
-  
-  /* check if the page is full, when the page is full, transfer the data to erase page */ 
-  if ((flash_status = flash_ee_full_check()) != FMC_STATUS_COMPLETE)
-  {
-    /* flash lock */
-    FMC_Lock();
-    
-    return flash_status;
-  }
-
-    /* flash lock */
-    FMC_Lock();
-  
-  return FMC_STATUS_COMPLETE;
-}
-
-/** 
-  * @brief  write data to the eeprom.
-  * @param  address: variable address.
-  * @param  data: data.
-  * @retval flash_status.
-  */
-FMC_STATUS_T flash_ee_data_write(uint16_t address, uint16_t data)
-{
-  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
-  
-  /* flash unlock */
-  FMC_Unlock();
-  
-  /* check if the page is full, when the page is full, transfer the data to erase page */ 
-  if ((flash_status = flash_ee_full_check()) != FMC_STATUS_COMPLETE)
-  {
-    /* flash lock */
-    FMC_Lock();
-
-    return flash_status;
-  }
-  
-   /* write data to flash */ 
-  if ((flash_status = flash_ee_write_no_check(address, data)) != FMC_STATUS_COMPLETE)
-  {
-    /* flash lock */
-    FMC_Lock();
-
-    return flash_status;
-  }
-  
-  /* check if the page is full, when the page is full, transfer the data to erase page */ 
-  if ((flash_status = flash_ee_full_check()) != FMC_STATUS_COMPLETE)
-  {
-    /* flash lock */
-    FMC_Lock();
-    
-    return flash_status;
-  }
-
-  /* flash lock */
-  FMC_Lock();
-  
-  return FMC_STATUS_COMPLETE;
-}
-
-/** 
-  * @brief  read data from the eeprom.
-  * @param  address: variable address.
-  * @param  pdata: data pointer.
-  * @retval read status:
-  *         - 0: data successfully read
-  *         - 1: failed to read data
-  */
-uint16_t flash_ee_data_read(uint16_t address, uint16_t* pdata)
-{
-  uint16_t valid_page;
-  uint16_t data_address;
-  uint32_t find_address;
-  uint32_t start_address;
-
-  /* get the valid page */
-  valid_page = flash_ee_valid_page_get(EE_VALID_PAGE_READ);
-
-  if (valid_page == EE_VALID_PAGE_NONE)
-  {
-    return  EE_VALID_PAGE_NONE;
-  }
-  
-  /* start address calculation */
-  start_address = EE_BASE_ADDRESS + valid_page * EE_PAGE_SIZE + 4;
-  
-  /* find address calculation */
-  find_address  = EE_BASE_ADDRESS + valid_page * EE_PAGE_SIZE + EE_PAGE_SIZE - 2;  
-  
-  while (find_address > start_address)
-  {
-    /* read variable address */
-    data_address = (*(__IO uint16_t*)find_address);
-
-    /* variable address matching */ 
-    if (address == data_address)
-    {
-      /* read data */ 
-      *pdata = (*(__IO uint16_t*)(find_address - 2));
-
-      /* data successfully read */
-      return 0;
-    }
-
-    /* find address - 4 */ 
-    find_address -= 4;
-  }
-
-  /* failed to read data */
-  return 1;
-}
-
+/**
+  **************************************************************************
+  * @file     eeprom.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    the driver library of the flash eeprom
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+  
+#include "eeprom.h"
+#include "eeprom_trace.h"
+
+/*!< storage backend operations */
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#define ee_unlock()                     FMC_Unlock()
+#define ee_lock()                       FMC_Lock()
+#define ee_halfword_program(addr, data) ee_traced(FMC_ProgramHalfWord(addr, data), addr)
+#define ee_buffer_program(addr, data, count) ee_traced(FMC_ProgramBuffer(addr, data, count), addr)
+#define ee_range_erase(addr, num, fail) ee_traced(FMC_EraseRange(addr, num, fail), addr)
+#else
+#define ee_unlock()                     flash_ee_nor_unlock()
+#define ee_lock()                       flash_ee_nor_lock()
+#define ee_halfword_program(addr, data) ee_traced(flash_ee_nor_halfword_program(addr, data), addr)
+#define ee_buffer_program(addr, data, count) ee_traced(flash_ee_nor_buffer_program(addr, data, count), addr)
+#define ee_range_erase(addr, num, fail) ee_traced(flash_ee_nor_range_erase(addr, num, fail), addr)
+#endif
+
+#define EE_COPY_RUN                     16                  /*!< records a page transfer programs in one run */
+
+#define EE_VALID_PAGE0                  ((uint16_t)0x0000)  /*!< the effective page is page 0 */ 
+#define EE_VALID_PAGE1                  ((uint16_t)0x0001)  /*!< the effective page is page 1 */ 
+#define EE_VALID_PAGE_NONE              ((uint16_t)0x0002)  /*!< no valid page found */
+                                                              
+#define EE_PAGE_ERASED                  ((uint16_t)0xFFFF)  /*!< page is in erased state */ 
+#define EE_PAGE_TRANSFER                ((uint16_t)0xCCCC)  /*!< page is in transfer state */ 
+#define EE_PAGE_VALID                   ((uint16_t)0x0000)  /*!< page is in valid state */ 
+
+/*!< page header: status halfword, then the number of records the last transfer wrote sorted
+     by variable address (slots 1 to n). EE_PREFIX_NONE means no transfer wrote the page. */
+#define EE_PAGE_PREFIX_OFFSET           ((uint32_t)0x0002)  /*!< offset of the sorted prefix length */
+#define EE_PREFIX_NONE                  ((uint16_t)0xFFFF)  /*!< no sorted prefix */
+
+
+#define EE_SLOT_ADDRESS(page, slot)     (*(__IO uint16_t*)((page) + (slot) * 4 + 2))  /*!< variable address of a record slot */
+
+/*!< a slot holds a live record unless it is erased, a superseded record or a group header */
+#define EE_RECORD_KEY(key)              (((key) != EE_ADDRESS_ERASED) && \
+                                         ((EE_RECORD_INVALIDATE == 0) || ((key) != EE_ADDRESS_DEAD)) && \
+                                         ((EE_GROUP_COMMIT == 0) || ((key) != EE_ADDRESS_GROUP)))
+
+#if (EE_PACKED_KEYS > 0)
+/*!< packed records are single halfwords (key << 8 | value) growing down from the page end,
+     the records grow up from slot 1 and an erased halfword always separates both */
+#define EE_PACKED_KEY(address)          ((uint16_t)((address) - EE_PACKED_BASE_ADDRESS) < EE_PACKED_KEYS)  /*!< variable stored packed */
+#if (EE_THREAD_SAFE > 0)
+#define EE_PAGE_RECORD_END(partition, page_address) (flash_ee_page_packed_peek((partition), (page_address)) & ~3UL)  /*!< end of the record slots */
+#else
+#define EE_PAGE_RECORD_END(partition, page_address) (flash_ee_page_packed_start((partition), (page_address)) & ~3UL)  /*!< end of the record slots */
+#endif
+#else
+#define EE_PACKED_KEY(address)          0  /*!< variable stored packed */
+#if (EE_COUNTER_TICKS > 0)
+#define EE_PAGE_RECORD_END(partition, page_address) (flash_ee_page_counter_start((partition), (page_address)) - 4)  /*!< end of the record slots */
+#else
+#define EE_PAGE_RECORD_END(partition, page_address) ((partition)->page_size)  /*!< end of the record slots */
+#endif
+#endif
+
+#if (EE_COUNTER_TICKS > 0)
+#if (EE_PACKED_KEYS > 0)
+#error "EE_PACKED_KEYS and EE_COUNTER_TICKS both use the page end, enable one of them"
+#endif
+/*!< counter runs grow down from the page end, each a header word (record slot, variable address)
+     at its top and EE_COUNTER_TICKS tick halfwords below it. an erased word always separates
+     the records from the runs */
+#define EE_COUNTER_RUN_SIZE             ((uint32_t)((EE_COUNTER_TICKS * 2 + 7) & ~3))  /*!< bytes of a counter run */
+#endif
+
+/**
+  * @brief  flash eeprom valid page get mode
+  */
+typedef enum
+{
+  EE_VALID_PAGE_READ                = 0x01, /*!< get valid page in read mode */
+  EE_VALID_PAGE_WRITE               = 0x02, /*!< get valid page in write mode */
+} ee_valid_page_type;
+
+/*!< partition of flash_ee_data_read and flash_ee_data_write, at EE_BASE_ADDRESS */
+static ee_partition_type ee_default_partition;
+
+/**
+  * @brief  flash eeprom deferred init step, run by flash_ee_init_service
+  */
+typedef enum
+{
+  EE_INIT_COLD                      = 0x00, /*!< bring the cold pages into a valid state */
+  EE_INIT_GROUP                     = 0x01, /*!< drop a group interrupted by a reset */
+  EE_INIT_HOT                       = 0x02, /*!< bring the hot pages into a valid state and load the hot set */
+  EE_INIT_INDEX                     = 0x03, /*!< build the index of the valid page */
+  EE_INIT_DONE                      = 0x04, /*!< nothing deferred */
+} ee_init_step_type;
+
+/*!< until the deferred init is done, reads scan the valid pages */
+static ee_init_step_type ee_init_step = EE_INIT_DONE;
+
+#if (EE_INDEX_BITS > 0)
+/**
+  * @brief  flash eeprom index state
+  */
+typedef enum
+{
+  EE_INDEX_INVALID                  = 0x00, /*!< index must be rebuilt from the valid page */
+  EE_INDEX_READY                    = 0x01, /*!< index describes every live variable of the page */
+  EE_INDEX_OVERFLOW                 = 0x02, /*!< more live variables than entries, page scans are used */
+} ee_index_state_type;
+
+/*!< open addressing hash index of the live variables, variable address -> record slot.
+     slot n is the record at page address + 4 * n, slot 0 (the page header) marks an empty
+     entry. the tag holds 8 more hash bits so that most probe mismatches are rejected
+     without reading the flash. */
+static uint16_t ee_index_slot[EE_INDEX_SIZE];
+static uint8_t  ee_index_tag[EE_INDEX_SIZE];
+static uint32_t ee_index_page = 0;                          /*!< page the index describes */
+static uint16_t ee_index_next = 0;                          /*!< first free record slot of that page */
+static ee_index_state_type ee_index_state = EE_INDEX_INVALID;
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+/*!< address of the newest packed record of the page it lies in, or the end of a page without
+     packed record, 0 when unknown. one word so that a reader never sees half of an update. */
+static uint32_t ee_packed_top = 0;
+#endif
+
+#if (EE_GROUP_COMMIT > 0)
+/*!< header address of a group whose save failed, 0 for none. the group is cut off at its
+     header whatever its last record holds, until the page holding it is erased. */
+static uint32_t ee_group_failed = 0;
+#endif
+
+#if (EE_HOT_KEYS > 0)
+/*!< write rate table. an entry with a record slot is a hot variable, its newest data is at
+     ee_hot_page + 4 * slot and the count holds its writes since the last hot page transfer.
+     an entry without slot is a cold candidate counting its writes towards EE_HOT_PROMOTE,
+     an entry without slot and count is free. */
+static uint16_t ee_hot_key[EE_HOT_KEYS];
+static uint16_t ee_hot_slot[EE_HOT_KEYS];
+static uint16_t ee_hot_count[EE_HOT_KEYS];
+static uint32_t ee_hot_page = 0;                            /*!< hot page the slots refer to */
+static ee_partition_type ee_hot_partition;                  /*!< hot page pair, at EE_HOT_BASE_ADDRESS */
+
+FMC_STATUS_T flash_ee_partition_append(ee_partition_type* partition, uint16_t address, uint16_t data);
+uint16_t flash_ee_partition_lookup(ee_partition_type* partition, uint16_t address, uint16_t* pdata, uint16_t scan);
+#endif
+
+#if (EE_THREAD_SAFE > 0)
+/*!< writer lock given to flash_ee_lock_register, none by default */
+static void (*ee_write_lock)(void) = NULL;
+static void (*ee_write_unlock)(void) = NULL;
+
+/*!< publication count, odd while a writer changes the pages or the ram state. a read that
+     sees it change reads again, a read that sees it odd scans the published page. */
+static __IO uint32_t ee_publish_seq = 0;
+
+#define ee_write_begin()                flash_ee_write_begin()
+#define ee_write_end(partition)         flash_ee_write_end(partition)
+#else
+#define ee_write_begin()
+#define ee_write_end(partition)
+#endif
+
+#if (EE_THREAD_SAFE > 0)
+/** 
+  * @brief  publish the page the readers of a partition use, within a writer window.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page holding every variable of the partition, 0 for none.
+  * @retval none
+  */
+void flash_ee_publish_page(ee_partition_type* partition, uint32_t page_address)
+{
+  partition->read_address = page_address;
+
+  /* a read started on the previous page reads again */
+  __DMB();
+  ee_publish_seq += 2;
+}
+#endif
+
+/** 
+  * @brief  erase eeprom page, one page can contain one or more sectors.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page 0 or page 1 address of the partition.
+  * @retval FMC_STATUS_T
+  */
+FMC_STATUS_T flash_ee_page_erase(ee_partition_type* partition, uint32_t page_address)
+{
+  FMC_STATUS_T flash_status;
+
+#if (EE_INDEX_BITS > 0)
+  /* the index no longer matches the page content */
+  if (page_address == ee_index_page)
+  {
+    ee_index_state = EE_INDEX_INVALID;
+  }
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+  if ((ee_packed_top - page_address - 1) < partition->page_size)
+  {
+    ee_packed_top = 0;
+  }
+#endif
+
+#if (EE_THREAD_SAFE > 0)
+  /* the readers leave the page before it is erased */
+  if (partition->read_address == page_address)
+  {
+    flash_ee_publish_page(partition, 0);
+  }
+#endif
+  
+  /* erase the sectors of the page as one chained range, stops at the first failing sector */ 
+  flash_status = ee_range_erase(page_address, partition->sector_num, NULL);
+
+#if (EE_GROUP_COMMIT > 0)
+  /* the failed group went with its page */
+  if ((flash_status == FMC_STATUS_COMPLETE) && ((ee_group_failed - page_address) < partition->page_size))
+  {
+    ee_group_failed = 0;
+  }
+#endif
+
+  ee_trace(EE_TRACE_ERASE, flash_status, partition->sector_num, page_address);
+
+  return flash_status;
+}
+
+/** 
+  * @brief  check whether an eeprom page is fully erased, so that its erase can be skipped.
+  *         four words are combined per compare and the check stops at the first
+  *         programmed word.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval blank status:
+  *         - 0: the page is blank
+  *         - 1: the page holds programmed data
+  */
+uint16_t flash_ee_page_blank_check(ee_partition_type* partition, uint32_t page_address)
+{
+  __IO uint32_t* find_address = (__IO uint32_t*)page_address;
+  __IO uint32_t* end_address  = (__IO uint32_t*)(page_address + partition->page_size);
+
+  while (find_address < end_address)
+  {
+    if ((find_address[0] & find_address[1] & find_address[2] & find_address[3]) != 0xFFFFFFFF)
+    {
+      return 1;
+    }
+
+    find_address += 4;
+  }
+
+  return 0;
+}
+
+/** 
+  * @brief  get the valid eeprom page.
+  * @param  partition: eeprom partition.
+  * @param  mode
+  *         - EE_VALID_PAGE_READ: get valid page in read mode 
+  *         - EE_VALID_PAGE_WRITE: get valid page in write mode
+  * @retval valid page
+  *         - EE_VALID_PAGE0: page 0 is valid
+  *         - EE_VALID_PAGE1: page 1 is valid
+  *         - EE_VALID_PAGE_NONE: no valid page
+  */
+uint16_t flash_ee_valid_page_get(ee_partition_type* partition, ee_valid_page_type mode)
+{
+  uint16_t page0_status;
+  uint16_t page1_status;
+
+  /* get page 0 status */ 
+  page0_status = (*(__IO uint16_t*)partition->base_address);
+
+  /* get page 1 status */ 
+  page1_status = (*(__IO uint16_t*)(partition->base_address + partition->page_size));
+
+  if (mode == EE_VALID_PAGE_READ)
+  {
+    if (page0_status == EE_PAGE_VALID)
+    {
+      /* page 0 is valid */ 
+      return EE_VALID_PAGE0;
+    }
+    else if (page1_status == EE_PAGE_VALID)
+    {
+      /* page 1 is valid */     
+      return EE_VALID_PAGE1;     
+    }  
+  }
+  else
+  {
+    if (page0_status == EE_PAGE_TRANSFER)
+    {
+      /* page 0 is valid */ 
+      return EE_VALID_PAGE0;
+    }
+    else if (page1_status == EE_PAGE_TRANSFER)
+    {
+      /* page 1 is valid */ 
+      return EE_VALID_PAGE1;
+    }
+    else if (page0_status == EE_PAGE_VALID)
+    {
+      /* page 0 is valid */ 
+      return EE_VALID_PAGE0;
+    }
+    else if (page1_status == EE_PAGE_VALID)
+    {
+      /* page 1 is valid */     
+      return EE_VALID_PAGE1;     
+    }  
+  }
+
+  /* no valid page found */
+  return EE_VALID_PAGE_NONE; 
+}
+
+#if (EE_PACKED_KEYS > 0)
+/** 
+  * @brief  scan the packed records of a page down from the page end to the separating
+  *         erased halfword.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval offset of the newest packed record, the page size when there is none.
+  */
+uint32_t flash_ee_page_packed_scan(ee_partition_type* partition, uint32_t page_address)
+{
+  uint32_t offset;
+
+  offset = partition->page_size;
+
+  while ((offset > 4) && ((*(__IO uint16_t*)(page_address + offset - 2)) != 0xFFFF))
+  {
+    offset -= 2;
+  }
+
+  return offset;
+}
+
+/** 
+  * @brief  get the start of the packed records of a page. they are scanned once, then
+  *         the start is kept.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval offset of the newest packed record, the page size when there is none.
+  */
+uint32_t flash_ee_page_packed_start(ee_partition_type* partition, uint32_t page_address)
+{
+  uint32_t top = ee_packed_top;
+
+  if ((top - page_address - 1) >= partition->page_size)
+  {
+    top = page_address + flash_ee_page_packed_scan(partition, page_address);
+
+    ee_packed_top = top;
+  }
+
+  return top - page_address;
+}
+
+#if (EE_THREAD_SAFE > 0)
+/** 
+  * @brief  get the start of the packed records of a page without keeping it, for the
+  *         paths a reader takes. the start is either unknown or exact, as a packed program
+  *         drops it before the flash changes.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval offset of the newest packed record, the page size when there is none.
+  */
+uint32_t flash_ee_page_packed_peek(ee_partition_type* partition, uint32_t page_address)
+{
+  uint32_t top = ee_packed_top;
+
+  if ((top - page_address - 1) >= partition->page_size)
+  {
+    return flash_ee_page_packed_scan(partition, page_address);
+  }
+
+  return top - page_address;
+}
+#endif
+#endif
+
+#if (EE_COUNTER_TICKS > 0)
+/** 
+  * @brief  get the start of the counter runs of a page, scanned down from the page end to
+  *         the first run whose header is erased.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval offset of the newest counter run, the page size when there is none.
+  */
+uint32_t flash_ee_page_counter_start(ee_partition_type* partition, uint32_t page_address)
+{
+  uint32_t offset;
+
+  offset = partition->page_size;
+
+  /* the page header stays below the runs */
+  while ((offset >= EE_COUNTER_RUN_SIZE + 4) && ((*(__IO uint32_t*)(page_address + offset - 4)) != 0xFFFFFFFF))
+  {
+    offset -= EE_COUNTER_RUN_SIZE;
+  }
+
+  return offset;
+}
+
+/** 
+  * @brief  count the ticks of a counter run, they are programmed down from its header.
+  * @param  header_address: run header address.
+  * @retval number of ticks.
+  */
+uint16_t flash_ee_counter_ticks(uint32_t header_address)
+{
+  uint16_t ticks = 0;
+
+  while ((ticks < EE_COUNTER_TICKS) && ((*(__IO uint16_t*)(header_address - 2 - ticks * 2)) != 0xFFFF))
+  {
+    ticks++;
+  }
+
+  return ticks;
+}
+
+/** 
+  * @brief  count the ticks of the counter runs of a record. a record gets a further run
+  *         once its newest one is full, so only the newest one is read.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page holding the record.
+  * @param  address: counter variable address.
+  * @param  slot: record slot.
+  * @param  pheader: newest run header address pointer, 0 when the record has no run.
+  * @retval number of ticks.
+  */
+uint16_t flash_ee_counter_count(ee_partition_type* partition, uint32_t page_address, uint16_t address, uint16_t slot, uint32_t* pheader)
+{
+  uint16_t ticks = 0;
+  uint32_t header_address;
+
+  *pheader = 0;
+
+  /* the runs are scanned from the oldest one */
+  for (header_address = page_address + partition->page_size - 4; header_address >= page_address + EE_COUNTER_RUN_SIZE; header_address -= EE_COUNTER_RUN_SIZE)
+  {
+    if ((*(__IO uint32_t*)header_address) == 0xFFFFFFFF)
+    {
+      break;
+    }
+
+    if ((*(__IO uint32_t*)header_address) == (((uint32_t)address << 16) | slot))
+    {
+      ticks    += (*pheader != 0) ? EE_COUNTER_TICKS : 0;
+      *pheader  = header_address;
+    }
+  }
+
+  if (*pheader != 0)
+  {
+    ticks += flash_ee_counter_ticks(*pheader);
+  }
+
+  return ticks;
+}
+#endif
+
+/** 
+  * @brief  get the first free record slot of a page.
+  *         records are appended in order, so the used slots form a prefix of the page
+  *         and a binary search finds its end.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval first free slot, the number of record slots when the page is full.
+  */
+uint16_t flash_ee_page_next_slot(ee_partition_type* partition, uint32_t page_address)
+{
+  uint16_t low = 1;
+  uint16_t high = (uint16_t)(EE_PAGE_RECORD_END(partition, page_address) / 4);
+  uint16_t middle;
+
+  while (low < high)
+  {
+    middle = low + (high - low) / 2;
+
+    if ((*(__IO uint32_t*)(page_address + middle * 4)) == 0xFFFFFFFF)
+    {
+      high = middle;
+    }
+    else
+    {
+      low = middle + 1;
+    }
+  }
+
+  return low;
+}
+
+#if (EE_GROUP_COMMIT > 0)
+/** 
+  * @brief  find where the complete records of a page end. a group header holds the
+  *         number of records that follow it, when a reset interrupted the group the
+  *         last of them is missing and the group is cut off at its header. a group whose
+  *         save failed is cut off at its header too.
+  * @param  page_address: page address.
+  * @param  next_slot: first free slot of the page.
+  * @retval header slot of an interrupted group, next_slot when there is none.
+  */
+uint16_t flash_ee_group_end(uint32_t page_address, uint16_t next_slot)
+{
+  uint16_t slot;
+  uint16_t count;
+  uint16_t prefix;
+
+  /* a group whose save failed, its last record may hold a value the failure left */
+  if ((ee_group_failed - page_address) < (uint32_t)next_slot * 4)
+  {
+    return (uint16_t)((ee_group_failed - page_address) / 4);
+  }
+
+  /* sorted prefix length, a transfer copies no group header */
+  prefix = (*(__IO uint16_t*)(page_address + EE_PAGE_PREFIX_OFFSET));
+
+  if (prefix == EE_PREFIX_NONE)
+  {
+    prefix = 0;
+  }
+
+  /* only the newest group can be interrupted */
+  for (slot = next_slot - 1; slot > prefix; slot--)
+  {
+    if (EE_SLOT_ADDRESS(page_address, slot) == EE_ADDRESS_GROUP)
+    {
+      count = (*(__IO uint16_t*)(page_address + slot * 4));
+
+      /* the variable address of the last record is programmed last */
+      if (((uint32_t)slot + count < next_slot) && (EE_SLOT_ADDRESS(page_address, slot + count) != EE_ADDRESS_ERASED))
+      {
+        return next_slot;
+      }
+
+      return slot;
+    }
+  }
+
+  return next_slot;
+}
+#endif
+
+/** 
+  * @brief  get the end of the records a read may use, the first free slot. until the
+  *         deferred init has dropped it, or while a writer may be saving one, an
+  *         interrupted group is cut off at its header.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page address.
+  * @retval first slot after the readable records.
+  */
+uint16_t flash_ee_page_read_end(ee_partition_type* partition, uint32_t page_address)
+{
+  uint16_t next_slot;
+
+  next_slot = flash_ee_page_next_slot(partition, page_address);
+
+#if (EE_GROUP_COMMIT > 0)
+#if (EE_THREAD_SAFE > 0)
+  if ((partition == &ee_default_partition) && ((ee_init_step <= EE_INIT_GROUP) || ((ee_publish_seq & 1) != 0)))
+#else
+  if ((partition == &ee_default_partition) && (ee_init_step <= EE_INIT_GROUP))
+#endif
+  {
+    return flash_ee_group_end(page_address, next_slot);
+  }
+#endif
+
+  return next_slot;
+}
+
+/** 
+  * @brief  search a page for the newest record of a variable.
+  *         the records appended since the last transfer are scanned backwards first,
+  *         then the sorted prefix written by the transfer is binary searched.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page to search.
+  * @param  address: variable address.
+  * @retval record address, 0 when the variable is not found.
+  */
+uint32_t flash_ee_page_find(ee_partition_type* partition, uint32_t page_address, uint16_t address)
+{
+  uint16_t prefix;
+  uint16_t low, high, middle, probe;
+  uint16_t data_address;
+  uint32_t find_address;
+  uint32_t start_address;
+
+  /* sorted prefix length */
+  prefix = (*(__IO uint16_t*)(page_address + EE_PAGE_PREFIX_OFFSET));
+
+  if (prefix == EE_PREFIX_NONE)
+  {
+    prefix = 0;
+  }
+
+  /* the tail starts after the sorted prefix */
+  start_address = page_address + prefix * 4 + 2;
+  
+  /* the newest record is just before the first free slot */
+  find_address  = page_address + flash_ee_page_read_end(partition, page_address) * 4 - 2;
+  
+  while (find_address > start_address)
+  {
+    /* variable address matching */ 
+    if ((*(__IO uint16_t*)find_address) == address)
+    {
+      return find_address - 2;
+    }
+
+    /* find address - 4 */ 
+    find_address -= 4;
+  }
+
+  /* binary search of the sorted prefix */
+  low  = 1;
+  high = prefix;
+
+  while (low <= high)
+  {
+    middle = low + (high - low) / 2;
+    probe  = middle;
+
+#if (EE_RECORD_INVALIDATE > 0)
+    /* a superseded record lost its variable address, compare the nearest live one below */
+    while ((probe >= low) && (EE_SLOT_ADDRESS(page_address, probe) == EE_ADDRESS_DEAD))
+    {
+      probe--;
+    }
+
+    if (probe < low)
+    {
+      low = middle + 1;
+      continue;
+    }
+#endif
+
+    data_address = EE_SLOT_ADDRESS(page_address, probe);
+
+    if (data_address == address)
+    {
+      return page_address + probe * 4;
+    }
+    else if (data_address < address)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = probe - 1;
+    }
+  }
+
+  return 0;
+}
+
+/** 
+  * @brief  get the data of a record. each tick of the counter runs of the record adds one
+  *         to the record data.
+  * @param  partition: eeprom partition.
+  * @param  record_address: record location.
+  * @retval data.
+  */
+uint16_t flash_ee_record_data(ee_partition_type* partition, uint32_t record_address)
+{
+  uint16_t data;
+#if (EE_COUNTER_TICKS > 0)
+  uint32_t page_address;
+  uint32_t header_address;
+
+  /* page holding the record */
+  page_address = record_address - (record_address - partition->base_address) % partition->page_size;
+#endif
+
+  data = (*(__IO uint16_t*)record_address);
+
+#if (EE_COUNTER_TICKS > 0)
+  data += flash_ee_counter_count(partition, page_address, (*(__IO uint16_t*)(record_address + 2)),
+                                 (uint16_t)((record_address - page_address) / 4), &header_address);
+#endif
+
+  return data;
+}
+
+#if (EE_PACKED_KEYS > 0)
+/** 
+  * @brief  search a page for the newest packed record of a variable, the packed records
+  *         are scanned from the newest one up to the page end.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page to search.
+  * @param  address: packed variable address.
+  * @retval packed record address, 0 when the variable is not found.
+  */
+uint32_t flash_ee_packed_find(ee_partition_type* partition, uint32_t page_address, uint16_t address)
+{
+  uint16_t key;
+  uint32_t find_address;
+  uint32_t end_address;
+
+  key = (uint16_t)(address - EE_PACKED_BASE_ADDRESS);
+
+  /* end address calculation */
+  end_address = page_address + partition->page_size;
+
+#if (EE_THREAD_SAFE > 0)
+  find_address = page_address + flash_ee_page_packed_peek(partition, page_address);
+#else
+  find_address = page_address + flash_ee_page_packed_start(partition, page_address);
+#endif
+
+  for (; find_address < end_address; find_address += 2)
+  {
+    if (((*(__IO uint16_t*)find_address) >> 8) == key)
+    {
+      return find_address;
+    }
+  }
+
+  return 0;
+}
+
+/** 
+  * @brief  append a packed record below the newest one of a page.
+  * @param  partition: eeprom partition.
+  * @param  page_address: page to write.
+  * @param  address: packed variable address.
+  * @param  data: data, 0 to 0xFF.
+  * @retval flash_status, FMC_STATUS_ERROR_PG when the page has no room left.
+  */
+FMC_STATUS_T flash_ee_packed_program(ee_partition_type* partition, uint32_t page_address, uint16_t address, uint16_t data)
+{
+  uint32_t offset;
+  FMC_STATUS_T flash_status;
+
+  offset = flash_ee_page_packed_start(partition, page_address);
+
+  /* an erased halfword must stay between the records and the packed records */
+  if (offset < (uint32_t)flash_ee_page_next_slot(partition, page_address) * 4 + 4)
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  offset -= 2;
+
+  /* the start is unknown until the program is done, a failed one leaves it so */
+  ee_packed_top = 0;
+
+  /* one halfword program per write */
+  if ((flash_status = ee_halfword_program(page_address + offset, (uint16_t)(((address - EE_PACKED_BASE_ADDRESS) << 8) | (data & 0xFF)))) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  ee_packed_top = page_address + offset;
+
+  return FMC_STATUS_COMPLETE;
+}
+#endif
+
+#if (EE_INDEX_BITS > 0)
+/** 
+  * @brief  locate a variable in the index.
+  * @param  address: variable address.
+  * @param  page_address: page the index slots refer to.
+  * @retval entry holding the variable, or the empty entry where it would be inserted.
+  *         EE_INDEX_SIZE when the variable is absent and the index is full.
+  */
+uint16_t flash_ee_index_find(uint16_t address, uint32_t page_address)
+{
+  uint16_t i, n;
+  uint8_t tag;
+  uint32_t hash;
+
+  /* multiplicative hash, the top bits select the entry, the next 8 bits form the tag */
+  hash = (uint32_t)address * 0x9E3779B1;
+  i    = (uint16_t)(hash >> (32 - EE_INDEX_BITS));
+  tag  = (uint8_t)(hash >> (24 - EE_INDEX_BITS));
+
+  for (n = 0; n < EE_INDEX_SIZE; n++)
+  {
+    /* empty entry, the variable is not stored */
+    if (ee_index_slot[i] == 0)
+    {
+      return i;
+    }
+
+    /* the tag filters most mismatches, the flash confirms the variable address */
+    if ((ee_index_tag[i] == tag) &&
+        ((*(__IO uint16_t*)(page_address + ee_index_slot[i] * 4 + 2)) == address))
+    {
+      return i;
+    }
+
+    /* linear probing */
+    i = (i + 1) & (EE_INDEX_SIZE - 1);
+  }
+
+  return EE_INDEX_SIZE;
+}
+
+/** 
+  * @brief  record the slot of a variable in the index.
+  * @param  address: variable address.
+  * @param  slot: record slot of the newest data.
+  * @param  page_address: page the slot refers to.
+  * @retval none
+  */
+void flash_ee_index_set(uint16_t address, uint16_t slot, uint32_t page_address)
+{
+  uint16_t i;
+
+  i = flash_ee_index_find(address, page_address);
+
+  if (i == EE_INDEX_SIZE)
+  {
+    /* more live variables than index entries */
+    ee_index_state = EE_INDEX_OVERFLOW;
+
+    return;
+  }
+
+  ee_index_tag[i]  = (uint8_t)(((uint32_t)address * 0x9E3779B1) >> (24 - EE_INDEX_BITS));
+  ee_index_slot[i] = slot;
+}
+
+/** 
+  * @brief  keep the index on a record just appended to a page.
+  * @param  address: variable address.
+  * @param  slot: record slot.
+  * @param  page_address: page holding the record.
+  * @retval none
+  */
+void flash_ee_index_append(uint16_t address, uint16_t slot, uint32_t page_address)
+{
+  if ((page_address == ee_index_page) && (ee_index_state != EE_INDEX_INVALID))
+  {
+    if (ee_index_state == EE_INDEX_READY)
+    {
+      flash_ee_index_set(address, slot, page_address);
+    }
+
+    ee_index_next = slot + 1;
+  }
+}
+
+/** 
+  * @brief  make sure the index describes the given valid page, rebuilding it if required.
+  *         the sorted prefix written by the last transfer is the checkpoint of the page:
+  *         it holds each variable once, so its slots are inserted without comparing
+  *         variable addresses. only the records appended after it are replayed, later
+  *         records replacing earlier ones.
+  * @param  partition: eeprom partition.
+  * @param  page_address: valid page address.
+  * @retval index status:
+  *         - 0: the index can be used
+  *         - 1: the index overflowed, scan the page instead
+  */
+uint16_t flash_ee_index_check(ee_partition_type* partition, uint32_t page_address)
+{
+  uint16_t i;
+  uint16_t slot;
+  uint16_t prefix;
+  uint16_t next_slot;
+  uint16_t data_address;
+  uint32_t hash;
+
+  if ((ee_index_state != EE_INDEX_INVALID) && (ee_index_page == page_address))
+  {
+    return (ee_index_state == EE_INDEX_READY) ? 0 : 1;
+  }
+
+  for (i = 0; i < EE_INDEX_SIZE; i++)
+  {
+    ee_index_slot[i] = 0;
+  }
+
+  ee_index_page  = page_address;
+  ee_index_state = EE_INDEX_READY;
+
+  /* sorted prefix length */
+  prefix = (*(__IO uint16_t*)(page_address + EE_PAGE_PREFIX_OFFSET));
+
+  if ((prefix == EE_PREFIX_NONE) || (prefix >= EE_INDEX_SIZE))
+  {
+    /* no checkpoint, or more variables than entries: replay every record */
+    prefix = 0;
+  }
+
+  /* load the checkpoint, each variable takes the first empty entry of its probe sequence */
+  for (slot = 1; slot <= prefix; slot++)
+  {
+#if (EE_RECORD_INVALIDATE > 0)
+    /* superseded since the transfer */
+    if (EE_SLOT_ADDRESS(page_address, slot) == EE_ADDRESS_DEAD)
+    {
+      continue;
+    }
+#endif
+
+    hash = (uint32_t)EE_SLOT_ADDRESS(page_address, slot) * 0x9E3779B1;
+    i    = (uint16_t)(hash >> (32 - EE_INDEX_BITS));
+
+    while (ee_index_slot[i] != 0)
+    {
+      i = (i + 1) & (EE_INDEX_SIZE - 1);
+    }
+
+    ee_index_tag[i]  = (uint8_t)(hash >> (24 - EE_INDEX_BITS));
+    ee_index_slot[i] = slot;
+  }
+
+  /* replay the records appended since the transfer */
+  next_slot = flash_ee_page_next_slot(partition, page_address);
+
+  for (; slot < next_slot; slot++)
+  {
+    data_address = EE_SLOT_ADDRESS(page_address, slot);
+
+    /* skip records interrupted before the variable address was programmed */
+    if (EE_RECORD_KEY(data_address))
+    {
+      flash_ee_index_set(data_address, slot, page_address);
+    }
+  }
+
+  ee_index_next = next_slot;
+
+  return (ee_index_state == EE_INDEX_READY) ? 0 : 1;
+}
+
+/** 
+  * @brief  restore the heap order below a root of the packed index slots.
+  * @param  page_address: page the index slots refer to.
+  * @param  root: entry to sift down.
+  * @param  end: number of entries in the heap.
+  * @retval none
+  */
+void flash_ee_index_sift(uint32_t page_address, uint16_t root, uint16_t end)
+{
+  uint16_t child;
+  uint16_t slot;
+
+  while ((child = root * 2 + 1) < end)
+  {
+    /* pick the child with the larger variable address */
+    if ((child + 1 < end) &&
+        (EE_SLOT_ADDRESS(page_address, ee_index_slot[child]) < EE_SLOT_ADDRESS(page_address, ee_index_slot[child + 1])))
+    {
+      child++;
+    }
+
+    if (EE_SLOT_ADDRESS(page_address, ee_index_slot[root]) >= EE_SLOT_ADDRESS(page_address, ee_index_slot[child]))
+    {
+      return;
+    }
+
+    slot = ee_index_slot[root];
+    ee_index_slot[root]  = ee_index_slot[child];
+    ee_index_slot[child] = slot;
+
+    root = child;
+  }
+}
+
+/** 
+  * @brief  pack the index slots to the front of the table and heap sort them by variable
+  *         address, the variable addresses are read from the flash. the hash layout is
+  *         lost, the index is left invalid.
+  * @param  page_address: page the index slots refer to.
+  * @retval number of live variables.
+  */
+uint16_t flash_ee_index_sort(uint32_t page_address)
+{
+  uint16_t i;
+  uint16_t count = 0;
+  uint16_t slot;
+
+  for (i = 0; i < EE_INDEX_SIZE; i++)
+  {
+    if (ee_index_slot[i] != 0)
+    {
+      ee_index_slot[count++] = ee_index_slot[i];
+    }
+  }
+
+  ee_index_state = EE_INDEX_INVALID;
+
+  /* build the heap */
+  for (i = count / 2; i > 0; i--)
+  {
+    flash_ee_index_sift(page_address, i - 1, count);
+  }
+
+  /* move the largest remaining slot to the end */
+  for (i = count; i > 1; i--)
+  {
+    slot = ee_index_slot[0];
+    ee_index_slot[0]     = ee_index_slot[i - 1];
+    ee_index_slot[i - 1] = slot;
+
+    flash_ee_index_sift(page_address, 0, i - 1);
+  }
+
+  return count;
+}
+#endif
+
+#if (EE_HOT_KEYS > 0)
+/** 
+  * @brief  locate a hot variable.
+  * @param  address: variable address.
+  * @retval entry of the variable, EE_HOT_KEYS when the variable is cold.
+  */
+uint16_t flash_ee_hot_find(uint16_t address)
+{
+  uint16_t i;
+
+  for (i = 0; i < EE_HOT_KEYS; i++)
+  {
+    if ((ee_hot_slot[i] != 0) && (ee_hot_key[i] == address))
+    {
+      return i;
+    }
+  }
+
+  return EE_HOT_KEYS;
+}
+
+/** 
+  * @brief  count a write of a variable and choose the page pair that stores it.
+  *         a cold variable is promoted once EE_HOT_PROMOTE writes are counted for it.
+  *         when no entry is free the cold candidates are aged instead, so that only
+  *         variables written more often than the others keep an entry.
+  * @param  address: variable address.
+  * @retval page pair:
+  *         - 0: the variable is cold
+  *         - 1: the variable is hot, or becomes hot with this write
+  */
+uint16_t flash_ee_hot_track(uint16_t address)
+{
+  uint16_t i;
+  uint16_t free_entry = EE_HOT_KEYS;
+
+  for (i = 0; i < EE_HOT_KEYS; i++)
+  {
+    if ((ee_hot_slot[i] == 0) && (ee_hot_count[i] == 0))
+    {
+      /* remember the first free entry */
+      if (free_entry == EE_HOT_KEYS)
+      {
+        free_entry = i;
+      }
+    }
+    else if (ee_hot_key[i] == address)
+    {
+      if (ee_hot_count[i] != 0xFFFF)
+      {
+        ee_hot_count[i]++;
+      }
+
+      return ((ee_hot_slot[i] != 0) || (ee_hot_count[i] >= EE_HOT_PROMOTE)) ? 1 : 0;
+    }
+  }
+
+  if (free_entry != EE_HOT_KEYS)
+  {
+    /* start counting a new candidate */
+    ee_hot_key[free_entry]   = address;
+    ee_hot_count[free_entry] = 1;
+
+    return 0;
+  }
+
+  /* table full, age the cold candidates */
+  for (i = 0; i < EE_HOT_KEYS; i++)
+  {
+    if ((ee_hot_slot[i] == 0) && (ee_hot_count[i] != 0))
+    {
+      ee_hot_count[i]--;
+    }
+  }
+
+  return 0;
+}
+
+/** 
+  * @brief  rebuild the hot variable entries from the valid hot page. the variables found
+  *         in the page are the hot set, so the classification survives a reset; the write
+  *         counts restart and each hot variable is kept through the next hot transfer.
+  * @param  page_address: valid hot page address.
+  * @retval load status:
+  *         - 0: every hot variable has an entry
+  *         - 1: the page holds more variables than entries, a transfer must demote them
+  */
+uint16_t flash_ee_hot_load(uint32_t page_address)
+{
+  uint16_t i;
+  uint16_t slot;
+  uint16_t data_address;
+  uint16_t overflow = 0;
+
+  for (i = 0; i < EE_HOT_KEYS; i++)
+  {
+    ee_hot_slot[i]  = 0;
+    ee_hot_count[i] = 0;
+  }
+
+  ee_hot_page = page_address;
+  i = 0;
+
+  /* walk from the newest record, the first record of a variable is its newest data */
+  for (slot = flash_ee_page_next_slot(&ee_hot_partition, page_address) - 1; slot > 0; slot--)
+  {
+    data_address = EE_SLOT_ADDRESS(page_address, slot);
+
+    if (!EE_RECORD_KEY(data_address) || (flash_ee_hot_find(data_address) != EE_HOT_KEYS))
+    {
+      continue;
+    }
+
+    if (i == EE_HOT_KEYS)
+    {
+      overflow = 1;
+
+      continue;
+    }
+
+    ee_hot_key[i]   = data_address;
+    ee_hot_slot[i]  = slot;
+    ee_hot_count[i] = 1;
+    i++;
+  }
+
+  return overflow;
+}
+
+/** 
+  * @brief  decide whether a variable of the full hot page moves to the new hot page.
+  *         hot variables without a write since the previous hot transfer are demoted,
+  *         the others restart their count with the new record slot.
+  * @param  full_page_address: hot page being transferred.
+  * @param  address: variable address.
+  * @param  slot: record slot of the variable in the new hot page.
+  * @retval transfer decision:
+  *         - 0: the variable is demoted to the cold pages
+  *         - 1: the variable stays hot
+  */
+uint16_t flash_ee_hot_keep(uint32_t full_page_address, uint16_t address, uint16_t slot)
+{
+  uint16_t i;
+
+  /* the entries are not loaded yet during the recovery at init, keep everything */
+  if (ee_hot_page != full_page_address)
+  {
+    return 1;
+  }
+
+  i = flash_ee_hot_find(address);
+
+  if (i == EE_HOT_KEYS)
+  {
+    /* variable without entry, left over from a larger EE_HOT_KEYS */
+    return 0;
+  }
+
+  if (ee_hot_count[i] == 0)
+  {
+    /* release the entry before the data is handed to the cold pages */
+    ee_hot_slot[i] = 0;
+
+    return 0;
+  }
+
+  ee_hot_slot[i]  = slot;
+  ee_hot_count[i] = 0;
+
+  return 1;
+}
+#endif
+
+/** 
+  * @brief  locate the newest record of a variable in the valid page of a partition.
+  * @param  partition: eeprom partition, the hot page pair included.
+  * @param  page_address: valid page address.
+  * @param  address: variable address.
+  * @retval record address, 0 when the variable is not stored.
+  */
+uint32_t flash_ee_record_find(ee_partition_type* partition, uint32_t page_address, uint16_t address)
+{
+#if ((EE_INDEX_BITS > 0) || (EE_HOT_KEYS > 0))
+  uint16_t i;
+#endif
+
+#if (EE_HOT_KEYS > 0)
+  /* the hot entries follow the newest record of each hot variable */
+  if (partition == &ee_hot_partition)
+  {
+    i = flash_ee_hot_find(address);
+
+    return (i == EE_HOT_KEYS) ? 0 : ee_hot_page + ee_hot_slot[i] * 4;
+  }
+#endif
+
+#if ((EE_INDEX_BITS > 0) && (EE_THREAD_SAFE > 0))
+  /* outside a writer window the index is used as the last writer left it, a read never
+     rebuilds it */
+  if ((partition == &ee_default_partition) && ((ee_publish_seq & 1) == 0) &&
+      ((ee_index_page != page_address) || (ee_index_state != EE_INDEX_READY)))
+  {
+    return flash_ee_page_find(partition, page_address, address);
+  }
+#endif
+
+#if (EE_INDEX_BITS > 0)
+  if ((partition == &ee_default_partition) && (flash_ee_index_check(partition, page_address) == 0))
+  {
+    i = flash_ee_index_find(address, page_address);
+
+    /* the index holds every live variable, a miss needs no page scan */
+    if ((i == EE_INDEX_SIZE) || (ee_index_slot[i] == 0))
+    {
+      return 0;
+    }
+
+    return page_address + ee_index_slot[i] * 4;
+  }
+#endif
+
+  return flash_ee_page_find(partition, page_address, address);
+}
+
+/** 
+  * @brief  write data to the eeprom.
+  * @param  partition: eeprom partition.
+  * @param  address: variable address.
+  * @param  data: data.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_write_no_check(ee_partition_type* partition, uint16_t address, uint16_t data)
+{
+  uint16_t valid_page;
+  uint32_t page_address;
+  uint32_t find_address; 
+  uint32_t end_address;
+  uint16_t record[2];
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+#if (EE_HOT_KEYS > 0)
+  uint16_t i;
+#endif
+#if (EE_RECORD_INVALIDATE > 0)
+  uint32_t old_address;
+#endif
+  
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_WRITE);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return  FMC_STATUS_ERROR_PG;
+  }
+
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+
+#if (EE_PACKED_KEYS > 0)
+  if (EE_PACKED_KEY(address))
+  {
+    return flash_ee_packed_program(partition, page_address, address, data);
+  }
+#endif
+
+#if (EE_RECORD_INVALIDATE > 0)
+  /* the record this write supersedes */
+  old_address = flash_ee_record_find(partition, page_address, address);
+#endif
+
+#if (EE_INDEX_BITS > 0)
+  /* the index knows the first free location of its page, skip the used part */
+  if ((page_address == ee_index_page) && (ee_index_state != EE_INDEX_INVALID))
+  {
+    find_address = page_address + ee_index_next * 4;
+  }
+  else
+#endif
+  {
+    /* find address calculation */ 
+    find_address = page_address + flash_ee_page_next_slot(partition, page_address) * 4;
+  }
+
+#if (EE_PACKED_KEYS > 0)
+  /* end address calculation, an erased halfword stays below the packed records */
+  end_address  = page_address + flash_ee_page_packed_start(partition, page_address) - 4;
+#elif (EE_COUNTER_TICKS > 0)
+  /* end address calculation, an erased word stays below the counter runs */
+  end_address  = page_address + EE_PAGE_RECORD_END(partition, page_address);
+#else
+  /* end address calculation */
+  end_address  = page_address + partition->page_size - 2;  
+#endif
+  
+  while (find_address < end_address)
+  {
+    /* find addresses without data */ 
+    if ((*(__IO uint32_t*)find_address) == 0xFFFFFFFF)
+    {
+      record[0] = data;
+      record[1] = address;
+
+      /* write data and then variable address to flash */ 
+      if ((flash_status = ee_buffer_program(find_address, record, 2)) != FMC_STATUS_COMPLETE)
+      {
+        return flash_status;
+      }
+
+#if (EE_INDEX_BITS > 0)
+      /* keep the index on the newest record */
+      flash_ee_index_append(address, (uint16_t)((find_address - page_address) / 4), page_address);
+#endif
+
+#if (EE_HOT_KEYS > 0)
+      /* a hot variable follows its newest record, a promoted one becomes hot here */
+      if (partition == &ee_hot_partition)
+      {
+        for (i = 0; i < EE_HOT_KEYS; i++)
+        {
+          if (((ee_hot_slot[i] != 0) || (ee_hot_count[i] != 0)) && (ee_hot_key[i] == address))
+          {
+            ee_hot_slot[i] = (uint16_t)((find_address - page_address) / 4);
+            break;
+          }
+        }
+
+        ee_hot_page = page_address;
+      }
+#endif
+
+#if (EE_RECORD_INVALIDATE > 0)
+      /* mark the superseded record dead, a 1 to 0 program needs no erase. a reset before
+         this leaves two live records and the newer one wins as without invalidation */
+      if (old_address != 0)
+      {
+        return ee_halfword_program(old_address + 2, EE_ADDRESS_DEAD);
+      }
+#endif
+      
+      return FMC_STATUS_COMPLETE;
+    }
+    else
+    {
+      /* find address + 4 */ 
+      find_address += 4;
+    }
+  }
+
+  return FMC_STATUS_ERROR_PG;
+}
+
+/** 
+  * @brief  transfer full page data to empty page.
+  *         every variable address found in the full page is carried over, so the whole
+  *         16-bit address range survives the transfer. the live variables are written
+  *         sorted by variable address and the count is stored in the page header, so
+  *         that reads without the ram index can binary search them. the packed variables
+  *         follow at the page end. the records of an interrupted group are dropped.
+  *         a hot page transfer hands the variables no longer hot to the cold pages, and a
+  *         cold page transfer drops the stale copies of the hot variables.
+  * @param  partition: eeprom partition.
+  * @retval flash_status
+  */
+FMC_STATUS_T flash_ee_copy_to_new_page(ee_partition_type* partition)
+{
+  uint16_t slot;
+  uint16_t next_slot;
+  uint16_t end_slot;
+  uint16_t data_address;
+  uint16_t valid_page;
+  int32_t  last_address;
+  uint32_t find_address;
+  uint32_t best_address;
+  uint32_t full_page_address;
+  uint32_t empty_page_address;
+  uint16_t run[EE_COPY_RUN * 2];
+  uint16_t run_num = 0;
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+#if (EE_INDEX_BITS > 0)
+  uint16_t i;
+  uint16_t count;
+#endif
+#if (EE_PACKED_KEYS > 0)
+  uint16_t packed_key;
+  uint32_t packed_seen[(EE_PACKED_KEYS + 31) / 32];
+#endif
+  
+  /* get valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE0) 
+  {
+    /* empty page is page 1 */
+    empty_page_address = partition->base_address + partition->page_size;
+
+    /* full page is pgae 0 */ 
+    full_page_address = partition->base_address;
+  }
+  else if (valid_page == EE_VALID_PAGE1) 
+  {
+    /* empty page is page 0 */
+    empty_page_address = partition->base_address;
+
+    /* full page is pgae 1 */
+    full_page_address = partition->base_address + partition->page_size;
+  }
+  else
+  {
+    /* page status flag error */ 
+    return FMC_STATUS_ERROR_PG; 
+  }
+
+  ee_trace(EE_TRACE_TRANSFER, 0, 0, full_page_address);
+
+  /* change the status of the empty page to TRANSFER */ 
+  if ((flash_status = ee_halfword_program(empty_page_address, EE_PAGE_TRANSFER)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  /* live variables are written sorted by variable address from slot 1 on */
+  slot = 1;
+
+  /* the records end at the first free slot */
+  next_slot = flash_ee_page_next_slot(partition, full_page_address);
+  end_slot  = next_slot;
+
+#if (EE_GROUP_COMMIT > 0)
+  /* or before a group interrupted by a reset, which is dropped */
+  end_slot  = flash_ee_group_end(full_page_address, next_slot);
+#endif
+
+#if (EE_INDEX_BITS > 0)
+  /* the index describes the cold pages only */
+  if ((partition == &ee_default_partition) && (end_slot == next_slot) && (flash_ee_index_check(partition, full_page_address) == 0))
+  {
+    /* the index lists each live variable once, sort it by variable address */
+    count = flash_ee_index_sort(full_page_address);
+
+    for (i = 0; i < count; i++)
+    {
+#if (EE_HOT_KEYS > 0)
+      /* the newest data of a hot variable is in the hot pages */
+      if (flash_ee_hot_find(EE_SLOT_ADDRESS(full_page_address, ee_index_slot[i])) != EE_HOT_KEYS)
+      {
+        continue;
+      }
+#endif
+
+      /* stage the variable, the ticks of a counter run are folded into the copied data */
+      run[run_num * 2]     = flash_ee_record_data(partition, full_page_address + ee_index_slot[i] * 4);
+      run[run_num * 2 + 1] = (*(__IO uint16_t*)(full_page_address + ee_index_slot[i] * 4 + 2));
+      run_num++;
+      slot++;
+
+      /* store a run of variables to new page */
+      if (run_num == EE_COPY_RUN)
+      {
+        if ((flash_status = ee_buffer_program(empty_page_address + (slot - run_num) * 4, run, run_num * 2)) != FMC_STATUS_COMPLETE)
+        {
+          return flash_status;
+        }
+
+        run_num = 0;
+      }
+    }
+  }
+  else
+#endif
+  {
+    last_address = -1;
+
+    while (1)
+    {
+      best_address = 0;
+
+      /* find the smallest variable address above the last one copied, walking from the
+         newest record so that the first record of a variable is its newest data */
+      for (find_address = full_page_address + end_slot * 4 - 2; find_address > full_page_address + 4; find_address -= 4)
+      {
+        data_address = (*(__IO uint16_t*)find_address);
+
+        if (EE_RECORD_KEY(data_address) && ((int32_t)data_address > last_address) &&
+            ((best_address == 0) || (data_address < (*(__IO uint16_t*)best_address))))
+        {
+          best_address = find_address;
+        }
+      }
+
+      /* all variables copied */
+      if (best_address == 0)
+      {
+        break;
+      }
+
+      last_address = (*(__IO uint16_t*)best_address);
+
+#if (EE_HOT_KEYS > 0)
+      if (partition == &ee_hot_partition)
+      {
+        if (flash_ee_hot_keep(full_page_address, (uint16_t)last_address, slot) == 0)
+        {
+          /* demoted, the newest data moves to the cold pages */
+          if ((flash_status = flash_ee_partition_append(&ee_default_partition, (uint16_t)last_address, flash_ee_record_data(partition, best_address - 2))) != FMC_STATUS_COMPLETE)
+          {
+            return flash_status;
+          }
+
+          continue;
+        }
+      }
+      else if (flash_ee_hot_find((uint16_t)last_address) != EE_HOT_KEYS)
+      {
+        /* the newest data of a hot variable is in the hot pages */
+        continue;
+      }
+#endif
+
+      /* stage the variable, the ticks of a counter run are folded into the copied data */
+      run[run_num * 2]     = flash_ee_record_data(partition, best_address - 2);
+      run[run_num * 2 + 1] = (*(__IO uint16_t*)(best_address));
+      run_num++;
+      slot++;
+
+      /* store a run of variables to new page */
+      if (run_num == EE_COPY_RUN)
+      {
+        if ((flash_status = ee_buffer_program(empty_page_address + (slot - run_num) * 4, run, run_num * 2)) != FMC_STATUS_COMPLETE)
+        {
+          return flash_status;
+        }
+
+        run_num = 0;
+      }
+    }
+  }
+
+  /* store the last run */
+  if ((run_num != 0) &&
+      ((flash_status = ee_buffer_program(empty_page_address + (slot - run_num) * 4, run, run_num * 2)) != FMC_STATUS_COMPLETE))
+  {
+    return flash_status;
+  }
+
+#if (EE_PACKED_KEYS > 0)
+  for (packed_key = 0; packed_key < (EE_PACKED_KEYS + 31) / 32; packed_key++)
+  {
+    packed_seen[packed_key] = 0;
+  }
+
+  /* the newest packed record of each variable, walking from the newest one */
+  for (find_address = full_page_address + flash_ee_page_packed_start(partition, full_page_address); find_address < full_page_address + partition->page_size; find_address += 2)
+  {
+    packed_key = (*(__IO uint16_t*)find_address) >> 8;
+
+    if ((packed_key < EE_PACKED_KEYS) && ((packed_seen[packed_key >> 5] & (1UL << (packed_key & 31))) == 0))
+    {
+      packed_seen[packed_key >> 5] |= (1UL << (packed_key & 31));
+
+      /* store variable to new page */
+      if ((flash_status = flash_ee_packed_program(partition, empty_page_address, EE_PACKED_BASE_ADDRESS + packed_key, (*(__IO uint16_t*)find_address))) != FMC_STATUS_COMPLETE)
+      {
+        return flash_status;
+      }
+    }
+  }
+#endif
+
+  /* record the length of the sorted prefix in the page header */
+  if ((flash_status = ee_halfword_program(empty_page_address + EE_PAGE_PREFIX_OFFSET, slot - 1)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+#if (EE_THREAD_SAFE > 0)
+  /* the new page holds every variable, the readers move to it before the old one is erased */
+  flash_ee_publish_page(partition, empty_page_address);
+#endif
+
+  /* erase old page */
+  if ((flash_status = flash_ee_page_erase(partition, full_page_address)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  /* change the status of the empty page to VALID */ 
+  if ((flash_status = ee_halfword_program(empty_page_address, EE_PAGE_VALID)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+#if (EE_HOT_KEYS > 0)
+  /* the hot slots now refer to the new page */
+  if ((partition == &ee_hot_partition) && (ee_hot_page == full_page_address))
+  {
+    ee_hot_page = empty_page_address;
+  }
+#endif
+
+  ee_trace(EE_TRACE_TRANSFER_END, 0, slot - 1, empty_page_address);
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/** 
+  * @brief  erase all pages to format eeprom.
+  * @param  partition: eeprom partition.
+  * @retval flash_status
+  */
+FMC_STATUS_T flash_ee_format(ee_partition_type* partition)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  ee_trace(EE_TRACE_RECOVER, 0, EE_TRACE_FORMAT, partition->base_address);
+
+  /* erase page 0, unless it is already blank */
+  if ((flash_ee_page_blank_check(partition, partition->base_address) != 0) &&
+      ((flash_status = flash_ee_page_erase(partition, partition->base_address)) != FMC_STATUS_COMPLETE))
+  {
+    return flash_status;
+  }
+
+  /* erase page 1, unless it is already blank */
+  if ((flash_ee_page_blank_check(partition, partition->base_address + partition->page_size) != 0) &&
+      ((flash_status = flash_ee_page_erase(partition, partition->base_address + partition->page_size)) != FMC_STATUS_COMPLETE))
+  {
+    return flash_status;
+  }
+  
+  /* mark the status of page 0 as VALID */
+  return ee_halfword_program(partition->base_address, EE_PAGE_VALID);
+}
+
+/** 
+  * @brief  eeprom format validity check.
+  * @param  page0_status: page0 status
+  * @param  page1_status: page1 status
+  * @retval format status:
+  *         - 0: the format is correct
+  *         - 1: the format is incorrect
+  */
+uint16_t flash_ee_format_check(uint16_t page0_status, uint16_t page1_status)
+{
+  /* the euqal status is invalid */
+  if (page0_status == page1_status)
+  {
+    return 1;
+  }
+  
+  /* status is not known status is invalid status */ 
+  if ((page0_status != EE_PAGE_ERASED) && (page0_status != EE_PAGE_TRANSFER) && (page0_status != EE_PAGE_VALID))
+  {
+    return 1;
+  }
+  
+  /* status is not known status is invalid status */ 
+  if ((page1_status != EE_PAGE_ERASED) && (page1_status != EE_PAGE_TRANSFER) && (page1_status != EE_PAGE_VALID))
+  {
+    return 1;
+  }
+  
+  /* the format is correct */
+  return 0;
+}
+
+/** 
+  * @brief  check if eeprom page is full, when the page is full, transfer the data to erase page.
+  * @param  partition: eeprom partition.
+  * @retval flash_status
+  */
+FMC_STATUS_T flash_ee_full_check(ee_partition_type* partition)
+{
+  uint16_t valid_page;
+#if (EE_PACKED_KEYS > 0) || (EE_COUNTER_TICKS > 0)
+  uint32_t page_address;
+#else
+  uint32_t end_address;
+#endif
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+  
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return  FMC_STATUS_ERROR_PG;
+  }
+
+#if (EE_PACKED_KEYS > 0)
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+
+  /* check if a record still fits with an erased halfword below the packed records */
+  if ((uint32_t)flash_ee_page_next_slot(partition, page_address) * 4 + 6 > flash_ee_page_packed_start(partition, page_address))
+#elif (EE_COUNTER_TICKS > 0)
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+
+  /* check if a record still fits with an erased word below the counter runs */
+  if ((uint32_t)flash_ee_page_next_slot(partition, page_address) * 4 + 4 > EE_PAGE_RECORD_END(partition, page_address))
+#else
+  /* end address calculation */
+  end_address  = partition->base_address + valid_page * partition->page_size + partition->page_size - 2;  
+
+  /* check if the page is full */ 
+  if ((*(__IO uint32_t*)(end_address - 2)) != 0xFFFFFFFF)
+#endif
+  {
+    /* when the page is full, transfer the data to erase page */ 
+    if ((flash_status = flash_ee_copy_to_new_page(partition)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+  }
+  
+  /* page full check ok */
+  return FMC_STATUS_COMPLETE;
+}
+
+/** 
+  * @brief  transition state processing, a page state is ERASE, a page state is TRANSFER, 
+  *         and the TRANSFER state is changed to VALID.
+  * @param  partition: eeprom partition.
+  * @param  page0_status: page0 status
+  * @param  page1_status: page1 status
+  * @retval format status:
+  *         - 0: the format is correct
+  *         - 1: the format is incorrect
+  */
+FMC_STATUS_T flash_ee_erase_transfer(ee_partition_type* partition, uint16_t page0_status, uint16_t page1_status)
+{
+  ee_trace(EE_TRACE_RECOVER, 0, EE_TRACE_MARK_VALID, partition->base_address);
+
+  if (page0_status == EE_PAGE_TRANSFER)
+  {
+    /* mark the status of page 0 as VALID */
+    return ee_halfword_program(partition->base_address, EE_PAGE_VALID);
+  }
+  else
+  {
+    /* mark the status of page 1 as VALID */
+    return ee_halfword_program(partition->base_address + partition->page_size, EE_PAGE_VALID);
+  }
+}
+
+/** 
+  * @brief  transition state processing, one page state is VALID, one page state is TRANSFER,
+  *         and the data is transferred to the TRANSFER state page.
+  * @param  partition: eeprom partition.
+  * @param  page0_status: page0 status
+  * @param  page1_status: page1 status
+  * @retval format status:
+  *         - 0: the format is correct
+  *         - 1: the format is incorrect
+  */
+FMC_STATUS_T flash_ee_valid_transfer(ee_partition_type* partition, uint16_t page0_status, uint16_t page1_status)
+{                                  
+  uint32_t erase_page_address;  
+  FMC_STATUS_T  flash_status;
+
+  ee_trace(EE_TRACE_RECOVER, 0, EE_TRACE_RESUME, partition->base_address);
+  
+  /* find the page in the transfer state, erase the page, and retransmit the data */ 
+  if (page0_status == EE_PAGE_TRANSFER)
+  {
+    erase_page_address = partition->base_address;
+  }
+  else
+  {
+    erase_page_address = partition->base_address + partition->page_size;
+  }
+  
+  /* erase the transfer state page */ 
+  if ((flash_status = flash_ee_page_erase(partition, erase_page_address)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+  
+  /* retransmit data */ 
+  return flash_ee_copy_to_new_page(partition);
+}
+
+/** 
+  * @brief  page pair init.
+  +-------------------+---------------------------------------------------------------------------------------------+
+  |                   |                                      PAGE 1 status                                          |
+  |                   +-----------------------+----------------------------------+----------------------------------+
+  |                   |         ERASE         |              TRANSFER            |              VALID               |
+  +--------+----------+-----------------------+----------------------------------+----------------------------------+
+  |        |          |  erase page 0         |  erase page 0                    |                                  |
+  |        | ERASE    |  erase page 1         |  mark  page 1 VALID              |   erase page 0                   |
+  |        |          |  mark  page 0 VALID   |                                  |                                  |
+  |        +----------+-----------------------+----------------------------------+----------------------------------+
+  |        |          |  erase page 1         |  erase page 0                    |  erase page 0                    |
+  | PAGE 0 | TRANSFER |  mark  page 0 VALID   |  erase page 1                    |  copy data from page 1 to page 0 |
+  | status |          |                       |  mark  page 0 VALID              |  erase page 1                    |
+  |        |          |                       |                                  |  mark  page 0 VALID              |
+  |        +----------+-----------------------+----------------------------------+----------------------------------+
+  |        |          |                       |  erase page 1                    |  erase page 0                    |
+  |        | VALID    |  erase page 1         |  copy data from page 0 to page 1 |  erase page 1                    |
+  |        |          |                       |  erase page 0                    |  mark  page 0 VALID              |
+  |        |          |                       |  mark  page 1 VALID              |                                  |
+  +--------+----------+-----------------------+----------------------------------+----------------------------------+
+  * @param  partition: eeprom partition.
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_partition_check(ee_partition_type* partition)
+{
+  uint16_t page0_status; 
+  uint16_t page1_status;
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  /* get page 0 status */ 
+  page0_status = (*(__IO uint16_t*)partition->base_address);
+
+  /* get page 2 status */ 
+  page1_status = (*(__IO uint16_t*)(partition->base_address + partition->page_size));
+
+  /* ensure that the sector data is completely erased */ 
+  if ((page0_status == EE_PAGE_ERASED) && (flash_ee_page_blank_check(partition, partition->base_address) != 0))
+  {
+    /* erase page 0 */
+    if ((flash_status = flash_ee_page_erase(partition, partition->base_address)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+  }
+
+  /* ensure that the sector data is completely erased */ 
+  if ((page1_status == EE_PAGE_ERASED) && (flash_ee_page_blank_check(partition, partition->base_address + partition->page_size) != 0))
+  {
+    /* erase page 1 */
+    if ((flash_status = flash_ee_page_erase(partition, partition->base_address + partition->page_size)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+  }  
+  
+  /* format validity check */
+  if (flash_ee_format_check(page0_status, page1_status) != 0)
+  {
+    /* if the format is invalid, reformat */
+    if ((flash_status = flash_ee_format(partition)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+  }
+  
+  /* transition state processing, a page state is ERASE, a page state is TRANSFER, and the TRANSFER state is changed to VALID */
+  if (((page0_status == EE_PAGE_ERASED) && (page1_status == EE_PAGE_TRANSFER)) || 
+     ((page0_status == EE_PAGE_TRANSFER) && (page1_status == EE_PAGE_ERASED)))
+  {
+    if ((flash_status = flash_ee_erase_transfer(partition, page0_status, page1_status)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+  }
+
+  /* transition state processing, one page state is VALID, one page state is TRANSFER, and the data is transferred to the TRANSFER state page */
+  if (((page0_status == EE_PAGE_VALID) && (page1_status == EE_PAGE_TRANSFER)) || 
+     ((page0_status == EE_PAGE_TRANSFER) && (page1_status == EE_PAGE_VALID)))
+  {
+    if ((flash_status = flash_ee_valid_transfer(partition, page0_status, page1_status)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+  }
+  
+  /* check if the page is full, when the page is full, transfer the data to erase page */ 
+  return flash_ee_full_check(partition);
+}
+
+/** 
+  * @brief  resolve the geometry of a partition.
+  * @param  partition: eeprom partition.
+  * @param  base_address: page 0 address, sector aligned. page 1 follows page 0.
+  * @param  sector_num: sectors per page.
+  * @param  address_min: lowest variable address accepted, EE_ADDRESS_MIN at least.
+  * @param  address_max: highest variable address accepted, EE_ADDRESS_MAX at most.
+  * @retval geometry status:
+  *         - 0: the geometry is valid
+  *         - 1: the geometry is invalid
+  */
+uint16_t flash_ee_partition_setup(ee_partition_type* partition, uint32_t base_address, uint16_t sector_num, uint16_t address_min, uint16_t address_max)
+{
+  /* record slots are numbered with 16 bits, which limits a page to 256K */
+  if ((sector_num == 0) || ((uint32_t)sector_num * EE_SECTOR_SIZE >= 0x40000) ||
+      ((base_address % EE_SECTOR_SIZE) != 0) ||
+      (address_min > address_max) || (address_max > EE_ADDRESS_MAX))
+  {
+    return 1;
+  }
+
+#if (EE_RECORD_INVALIDATE > 0)
+  /* the address of a superseded record is reserved */
+  if (address_min < EE_ADDRESS_MIN)
+  {
+    return 1;
+  }
+#endif
+
+  partition->base_address = base_address;
+  partition->sector_size  = EE_SECTOR_SIZE;
+  partition->page_size    = EE_SECTOR_SIZE * sector_num;
+  partition->sector_num   = sector_num;
+  partition->address_min  = address_min;
+  partition->address_max  = address_max;
+#if (EE_THREAD_SAFE > 0)
+  partition->read_address = 0;
+#endif
+
+  return 0;
+}
+
+#if (EE_THREAD_SAFE > 0)
+/** 
+  * @brief  register the lock that serializes the writers, a mutex of the rtos for instance.
+  *         the writes, the init and the passes over all variables take it, reads do not.
+  * @param  lock: take the lock, NULL for none.
+  * @param  unlock: give the lock back, NULL for none.
+  * @retval none
+  */
+void flash_ee_lock_register(void (*lock)(void), void (*unlock)(void))
+{
+  ee_write_lock   = lock;
+  ee_write_unlock = unlock;
+}
+
+/** 
+  * @brief  open a writer window: take the writer lock and mark the published state as
+  *         changing, reads started from now on scan the published page.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_write_begin(void)
+{
+  if (ee_write_lock != NULL)
+  {
+    ee_write_lock();
+  }
+
+  ee_publish_seq++;
+  __DMB();
+}
+
+/** 
+  * @brief  publish the valid page of a partition, kept when no page is valid as a failed
+  *         transfer does not erase the page published last.
+  * @param  partition: eeprom partition.
+  * @retval none
+  */
+void flash_ee_read_refresh(ee_partition_type* partition)
+{
+  uint16_t valid_page;
+
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if ((valid_page != EE_VALID_PAGE_NONE) &&
+      (partition->read_address != partition->base_address + valid_page * partition->page_size))
+  {
+    flash_ee_publish_page(partition, partition->base_address + valid_page * partition->page_size);
+  }
+}
+
+/** 
+  * @brief  close a writer window: publish the valid pages, leave the ram index and the
+  *         packed start built for the readers, which do not build them, and give the
+  *         writer lock back.
+  * @param  partition: eeprom partition written, the hot page pair included.
+  * @retval none
+  */
+void flash_ee_write_end(ee_partition_type* partition)
+{
+#if (EE_HOT_KEYS > 0)
+  /* the hot pages go with the cold ones */
+  if (partition == &ee_hot_partition)
+  {
+    partition = &ee_default_partition;
+  }
+#endif
+
+  flash_ee_read_refresh(partition);
+
+  if (partition == &ee_default_partition)
+  {
+#if (EE_HOT_KEYS > 0)
+    /* a cold write may transfer the hot pages, a hot one the cold pages */
+    flash_ee_read_refresh(&ee_hot_partition);
+#endif
+
+#if (EE_INDEX_BITS > 0)
+    if ((ee_init_step == EE_INIT_DONE) && (partition->read_address != 0))
+    {
+      flash_ee_index_check(partition, partition->read_address);
+    }
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+    if (partition->read_address != 0)
+    {
+      flash_ee_page_packed_start(partition, partition->read_address);
+    }
+#endif
+  }
+
+  __DMB();
+  ee_publish_seq++;
+
+  if (ee_write_unlock != NULL)
+  {
+    ee_write_unlock();
+  }
+}
+#endif
+
+/** 
+  * @brief  set up an eeprom partition and bring its page pair into a valid state.
+  *         every partition has its own transfer cycle, so writes to one never recopy
+  *         the variables of another. the ram index and the hot pages serve the
+  *         partition of flash_ee_init only.
+  * @param  partition: eeprom partition.
+  * @param  base_address: page 0 address, sector aligned. page 1 follows page 0.
+  * @param  sector_num: sectors per page.
+  * @param  address_min: lowest variable address accepted, EE_ADDRESS_MIN at least.
+  * @param  address_max: highest variable address accepted, EE_ADDRESS_MAX at most.
+  * @retval flash status, FMC_STATUS_ERROR_PG when the geometry is invalid.
+  */
+FMC_STATUS_T flash_ee_partition_init(ee_partition_type* partition, uint32_t base_address, uint16_t sector_num, uint16_t address_min, uint16_t address_max)
+{
+  FMC_STATUS_T flash_status;
+
+  if (flash_ee_partition_setup(partition, base_address, sector_num, address_min, address_max) != 0)
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  ee_write_begin();
+
+  /* flash unlock */
+  ee_unlock();
+
+  flash_status = flash_ee_partition_check(partition);
+
+  /* flash lock */
+  ee_lock();
+
+  ee_write_end(partition);
+
+  return flash_status;
+}
+
+#if (EE_GROUP_COMMIT > 0)
+/** 
+  * @brief  drop a group interrupted by a reset or a failed program, by transferring the
+  *         valid page without it.
+  * @param  partition: eeprom partition.
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_group_check(ee_partition_type* partition)
+{
+  uint16_t next_slot;
+  uint16_t valid_page;
+  uint32_t page_address;
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+  next_slot    = flash_ee_page_next_slot(partition, page_address);
+
+  if (flash_ee_group_end(page_address, next_slot) != next_slot)
+  {
+    ee_trace(EE_TRACE_RECOVER, 0, EE_TRACE_ROLLBACK, partition->base_address);
+
+    return flash_ee_copy_to_new_page(partition);
+  }
+
+  return FMC_STATUS_COMPLETE;
+}
+#endif
+
+/** 
+  * @brief  mark a page left in the TRANSFER state beside an ERASED page VALID. the
+  *         transfer copied every variable, only its VALID mark is missing.
+  * @param  partition: eeprom partition.
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_transfer_check(ee_partition_type* partition)
+{
+  uint16_t page0_status; 
+  uint16_t page1_status;
+
+  /* get page 0 status */ 
+  page0_status = (*(__IO uint16_t*)partition->base_address);
+
+  /* get page 1 status */ 
+  page1_status = (*(__IO uint16_t*)(partition->base_address + partition->page_size));
+
+  if (((page0_status == EE_PAGE_ERASED) && (page1_status == EE_PAGE_TRANSFER)) || 
+     ((page0_status == EE_PAGE_TRANSFER) && (page1_status == EE_PAGE_ERASED)))
+  {
+    return flash_ee_erase_transfer(partition, page0_status, page1_status);
+  }
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/** 
+  * @brief  eeprom init, constant time part. validates the page headers so that reads can
+  *         start, the erases, transfers and index build are deferred to
+  *         flash_ee_init_service. until it is done a read scans the valid page, a write
+  *         or a pass over all variables completes the deferred init first.
+  * @param  none
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_init_start(void)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  ee_write_begin();
+
+  /* resolve the geometry once, EE_BASE_ADDRESS reads the flash size register */
+  flash_ee_partition_setup(&ee_default_partition, EE_BASE_ADDRESS, EE_SECTOR_NUM, EE_ADDRESS_MIN, EE_ADDRESS_MAX);
+
+#if (EE_HOT_KEYS > 0)
+  flash_ee_partition_setup(&ee_hot_partition, EE_HOT_BASE_ADDRESS, EE_SECTOR_NUM, EE_ADDRESS_MIN, EE_ADDRESS_MAX);
+
+  /* the hot entries are reloaded by the service, an interrupted hot transfer keeps every variable */
+  ee_hot_page = 0;
+#endif
+
+#if (EE_INDEX_BITS > 0)
+  /* the index is rebuilt by the service */
+  ee_index_state = EE_INDEX_INVALID;
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+  /* the packed start is scanned again */
+  ee_packed_top = 0;
+#endif
+
+  ee_init_step = EE_INIT_COLD;
+
+  /* flash unlock */
+  ee_unlock();
+
+  /* a transfer interrupted before its VALID mark leaves no page to read */
+  flash_status = flash_ee_transfer_check(&ee_default_partition);
+
+#if (EE_HOT_KEYS > 0)
+  if (flash_status == FMC_STATUS_COMPLETE)
+  {
+    flash_status = flash_ee_transfer_check(&ee_hot_partition);
+  }
+#endif
+
+  /* flash lock */
+  ee_lock();
+
+  ee_write_end(&ee_default_partition);
+
+  return flash_status;
+}
+
+/** 
+  * @brief  run one step of the deferred init, the steps in order: the cold page checks,
+  *         the rollback of an interrupted group, the hot page checks and the hot set,
+  *         the index. after a failed step the next call starts over.
+  * @param  none
+  * @retval FMC_STATUS_BUSY: steps remain.
+  *         FMC_STATUS_COMPLETE: the init is done.
+  *         else the flash status of the failed step.
+  */
+FMC_STATUS_T flash_ee_init_service(void)
+{
+#if ((EE_INDEX_BITS > 0) || (EE_HOT_KEYS > 0))
+  uint16_t valid_page;
+#endif
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  if (ee_init_step == EE_INIT_DONE)
+  {
+    return FMC_STATUS_COMPLETE;
+  }
+
+  ee_write_begin();
+
+#if (EE_THREAD_SAFE > 0)
+  /* another thread finished it while this one waited for the lock */
+  if (ee_init_step == EE_INIT_DONE)
+  {
+    ee_write_end(&ee_default_partition);
+
+    return FMC_STATUS_COMPLETE;
+  }
+#endif
+
+  /* flash unlock */
+  ee_unlock();
+
+  switch (ee_init_step)
+  {
+    case EE_INIT_COLD:
+      /* the cold pages first, a hot transfer may demote variables into them */
+      flash_status = flash_ee_partition_check(&ee_default_partition);
+      break;
+
+#if (EE_GROUP_COMMIT > 0)
+    case EE_INIT_GROUP:
+      /* a struct save interrupted by a reset is rolled back */
+      flash_status = flash_ee_group_check(&ee_default_partition);
+      break;
+#endif
+
+#if (EE_HOT_KEYS > 0)
+    case EE_INIT_HOT:
+      if ((flash_status = flash_ee_partition_check(&ee_hot_partition)) != FMC_STATUS_COMPLETE)
+      {
+        break;
+      }
+
+      /* the variables of the valid hot page are the hot set */
+      valid_page = flash_ee_valid_page_get(&ee_hot_partition, EE_VALID_PAGE_READ);
+
+      if ((valid_page != EE_VALID_PAGE_NONE) &&
+          (flash_ee_hot_load(ee_hot_partition.base_address + valid_page * ee_hot_partition.page_size) != 0))
+      {
+        /* more hot variables than entries, demote the ones left out */
+        flash_status = flash_ee_copy_to_new_page(&ee_hot_partition);
+      }
+      break;
+#endif
+
+#if (EE_INDEX_BITS > 0)
+    case EE_INIT_INDEX:
+      /* load the index from the checkpoint of the valid page */
+      valid_page = flash_ee_valid_page_get(&ee_default_partition, EE_VALID_PAGE_READ);
+
+      if (valid_page != EE_VALID_PAGE_NONE)
+      {
+        flash_ee_index_check(&ee_default_partition, ee_default_partition.base_address + valid_page * ee_default_partition.page_size);
+      }
+      break;
+#endif
+
+    default:
+      break;
+  }
+
+  /* flash lock */
+  ee_lock();
+
+  if (flash_status != FMC_STATUS_COMPLETE)
+  {
+    /* a failed step may leave a page pair in transfer, the next call starts over */
+    ee_init_step = EE_INIT_COLD;
+  }
+  else
+  {
+    ee_init_step = (ee_init_step_type)(ee_init_step + 1);
+    flash_status = (ee_init_step == EE_INIT_DONE) ? FMC_STATUS_COMPLETE : FMC_STATUS_BUSY;
+  }
+
+  ee_write_end(&ee_default_partition);
+
+  return flash_status;
+}
+
+/** 
+  * @brief  run the remaining steps of the deferred init.
+  * @param  none
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_init_finish(void)
+{
+  FMC_STATUS_T flash_status;
+
+  while ((flash_status = flash_ee_init_service()) == FMC_STATUS_BUSY)
+  {
+  }
+
+  return flash_status;
+}
+
+/** 
+  * @brief  eeprom init, brings the cold pages and, when enabled, the hot pages into a
+  *         valid state and reloads the hot variables from the hot page.
+  * @param  none
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_init(void)
+{
+  FMC_STATUS_T flash_status;
+
+  if ((flash_status = flash_ee_init_start()) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  return flash_ee_init_finish();
+}
+
+/** 
+  * @brief  write data to a page pair, transferring its page when full.
+  * @param  partition: eeprom partition.
+  * @param  address: variable address.
+  * @param  data: data.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_partition_append(ee_partition_type* partition, uint16_t address, uint16_t data)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+  
+  /* check if the page is full, when the page is full, transfer the data to erase page */ 
+  if ((flash_status = flash_ee_full_check(partition)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+  
+   /* write data to flash */ 
+  if ((flash_status = flash_ee_write_no_check(partition, address, data)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+  
+  /* check if the page is full, when the page is full, transfer the data to erase page */ 
+  return flash_ee_full_check(partition);
+}
+
+/** 
+  * @brief  write data to an eeprom partition.
+  * @param  partition: eeprom partition.
+  * @param  address: variable address.
+  * @param  data: data.
+  * @retval flash_status, FMC_STATUS_ERROR_PG when the address is outside the partition
+  *         or the data of a packed variable exceeds 0xFF.
+  */
+FMC_STATUS_T flash_ee_partition_write(ee_partition_type* partition, uint16_t address, uint16_t data)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  if ((address < partition->address_min) || (address > partition->address_max))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+#if (EE_PACKED_KEYS > 0)
+  if (EE_PACKED_KEY(address) && (data > 0xFF))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+#endif
+
+  /* a write completes the deferred init first */
+  if ((partition == &ee_default_partition) && ((flash_status = flash_ee_init_finish()) != FMC_STATUS_COMPLETE))
+  {
+    return flash_status;
+  }
+  
+  ee_write_begin();
+
+  /* flash unlock */
+  ee_unlock();
+
+#if (EE_HOT_KEYS > 0)
+  /* the most written variables go to the hot pages, a packed write is already a single program */
+  if ((partition == &ee_default_partition) && !EE_PACKED_KEY(address) && (flash_ee_hot_track(address) != 0))
+  {
+    partition = &ee_hot_partition;
+  }
+#endif
+  
+  flash_status = flash_ee_partition_append(partition, address, data);
+
+  /* flash lock */
+  ee_lock();
+
+  ee_write_end(partition);
+
+  ee_trace(EE_TRACE_WRITE, flash_status, address, data);
+  
+  return flash_status;
+}
+
+/** 
+  * @brief  write data to the eeprom.
+  * @param  address: variable address.
+  * @param  data: data.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_data_write(uint16_t address, uint16_t data)
+{
+  ee_capture(EE_CAPTURE_WRITE, address, data);
+
+  return flash_ee_partition_write(&ee_default_partition, address, data);
+}
+
+#if (EE_COUNTER_TICKS > 0)
+/** 
+  * @brief  increment a counter. the newest record of a counter gets a run of
+  *         EE_COUNTER_TICKS tick halfwords at the page end and an increment programs one
+  *         tick, a full run is followed by a further run for the same record. when no run
+  *         fits the counter value is written as a new record.
+  * @param  partition: eeprom partition, the hot page pair included.
+  * @param  address: counter variable address.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_counter_tick(ee_partition_type* partition, uint16_t address)
+{
+  uint16_t data;
+  uint16_t slot;
+  uint16_t ticks;
+  uint16_t run_ticks;
+  uint16_t valid_page;
+  uint16_t header[2];
+  uint32_t page_address;
+  uint32_t start_offset;
+  uint32_t header_address;
+  uint32_t record_address;
+  FMC_STATUS_T flash_status;
+
+  /* check if the page is full, when the page is full, transfer the data to erase page */ 
+  if ((flash_status = flash_ee_full_check(partition)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return  FMC_STATUS_ERROR_PG;
+  }
+
+  /* page address calculation */
+  page_address   = partition->base_address + valid_page * partition->page_size;
+  record_address = flash_ee_record_find(partition, page_address, address);
+
+  if (record_address == 0)
+  {
+    data = 0;
+
+#if (EE_HOT_KEYS > 0)
+    /* a counter just promoted to the hot pages continues from its cold value */
+    if (partition == &ee_hot_partition)
+    {
+      flash_ee_partition_lookup(&ee_default_partition, address, &data, 0);
+    }
+#endif
+
+    /* first increment in these pages, an absent counter starts from 0 */
+    return flash_ee_partition_append(partition, address, data + 1);
+  }
+
+  slot  = (uint16_t)((record_address - page_address) / 4);
+  ticks = flash_ee_counter_count(partition, page_address, address, slot, &header_address);
+
+  if (header_address != 0)
+  {
+    run_ticks = flash_ee_counter_ticks(header_address);
+
+    if (run_ticks < EE_COUNTER_TICKS)
+    {
+      /* one halfword program per increment */
+      return ee_halfword_program(header_address - 2 - run_ticks * 2, 0);
+    }
+  }
+
+  /* reserve a run for the record while a record still fits below it */
+  start_offset = flash_ee_page_counter_start(partition, page_address);
+
+  if ((uint32_t)flash_ee_page_next_slot(partition, page_address) * 4 + EE_COUNTER_RUN_SIZE + 8 > start_offset)
+  {
+    /* fold the ticks into a new record */
+    return flash_ee_partition_append(partition, address, (*(__IO uint16_t*)record_address) + ticks + 1);
+  }
+
+  header_address = page_address + start_offset - 4;
+  header[0]      = slot;
+  header[1]      = address;
+
+  /* record slot and then variable address, a run cut before its variable address matches none */
+  if ((flash_status = ee_buffer_program(header_address, header, 2)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  return ee_halfword_program(header_address - 2, 0);
+}
+
+/** 
+  * @brief  increment a counter variable of an eeprom partition. the counter is read
+  *         like any variable, an absent counter reads as not found and starts from 0.
+  * @param  partition: eeprom partition.
+  * @param  address: counter variable address.
+  * @retval flash_status, FMC_STATUS_ERROR_PG when the address is outside the partition
+  *         or is a packed variable.
+  */
+FMC_STATUS_T flash_ee_partition_counter_increment(ee_partition_type* partition, uint16_t address)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  if ((address < partition->address_min) || (address > partition->address_max) || EE_PACKED_KEY(address))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  /* a write completes the deferred init first */
+  if ((partition == &ee_default_partition) && ((flash_status = flash_ee_init_finish()) != FMC_STATUS_COMPLETE))
+  {
+    return flash_status;
+  }
+  
+  ee_write_begin();
+
+  /* flash unlock */
+  ee_unlock();
+
+#if (EE_HOT_KEYS > 0)
+  /* the most written variables go to the hot pages */
+  if ((partition == &ee_default_partition) && (flash_ee_hot_track(address) != 0))
+  {
+    partition = &ee_hot_partition;
+  }
+#endif
+  
+  flash_status = flash_ee_counter_tick(partition, address);
+
+  /* flash lock */
+  ee_lock();
+
+  ee_write_end(partition);
+
+  ee_trace(EE_TRACE_INCREMENT, flash_status, address, 0);
+  
+  return flash_status;
+}
+
+/** 
+  * @brief  increment a counter variable of the eeprom.
+  * @param  address: counter variable address.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_counter_increment(uint16_t address)
+{
+  ee_capture(EE_CAPTURE_INCREMENT, address, 0);
+
+  return flash_ee_partition_counter_increment(&ee_default_partition, address);
+}
+#endif
+
+/** 
+  * @brief  look a variable up in an eeprom partition.
+  * @param  partition: eeprom partition.
+  * @param  address: variable address.
+  * @param  pdata: data pointer.
+  * @param  scan: 1 to scan the valid page without the ram index and hot entries, which a
+  *         writer may be changing.
+  * @retval read status:
+  *         - 0: data successfully read
+  *         - 1: failed to read data
+  */
+uint16_t flash_ee_partition_lookup(ee_partition_type* partition, uint16_t address, uint16_t* pdata, uint16_t scan)
+{
+#if (EE_THREAD_SAFE == 0)
+  uint16_t valid_page;
+#endif
+  uint32_t page_address;
+  uint32_t record_address;
+
+  if ((address < partition->address_min) || (address > partition->address_max))
+  {
+    return 1;
+  }
+
+#if (EE_HOT_KEYS > 0)
+  if ((partition == &ee_default_partition) && ((scan != 0) || (ee_init_step <= EE_INIT_HOT)))
+  {
+    /* the hot set is not loaded yet or is being changed, a variable found in the hot page is hot */
+    if (!EE_PACKED_KEY(address) && (flash_ee_partition_lookup(&ee_hot_partition, address, pdata, scan) == 0))
+    {
+      return 0;
+    }
+  }
+  else if ((partition == &ee_default_partition) && (flash_ee_hot_find(address) != EE_HOT_KEYS))
+  {
+    /* a hot variable is read from the hot page */
+    partition = &ee_hot_partition;
+  }
+#endif
+
+  /* a page pair the deferred init will format holds no variable */
+  if ((ee_init_step != EE_INIT_DONE) &&
+      (flash_ee_format_check((*(__IO uint16_t*)partition->base_address),
+                             (*(__IO uint16_t*)(partition->base_address + partition->page_size))) != 0))
+  {
+    return 1;
+  }
+
+#if (EE_THREAD_SAFE > 0)
+  /* the page published last, it stays readable while the writer transfers it */
+  page_address = partition->read_address;
+
+  if (page_address == 0)
+  {
+    return  EE_VALID_PAGE_NONE;
+  }
+#else
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return  EE_VALID_PAGE_NONE;
+  }
+
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+  if (EE_PACKED_KEY(address))
+  {
+    record_address = flash_ee_packed_find(partition, page_address, address);
+
+    if (record_address == 0)
+    {
+      return 1;
+    }
+
+    /* read data */
+    *pdata = (*(__IO uint16_t*)record_address) & 0xFF;
+
+    return 0;
+  }
+#endif
+
+  if ((scan != 0) || (ee_init_step != EE_INIT_DONE))
+  {
+    /* the index and the hot entries are not built yet or are being changed, scan the page */
+    record_address = flash_ee_page_find(partition, page_address, address);
+  }
+  else
+  {
+    record_address = flash_ee_record_find(partition, page_address, address);
+  }
+
+  if (record_address == 0)
+  {
+    return 1;
+  }
+
+  /* read data */
+  *pdata = flash_ee_record_data(partition, record_address);
+
+  return 0;
+}
+
+/** 
+  * @brief  read data from an eeprom partition.
+  * @param  partition: eeprom partition.
+  * @param  address: variable address.
+  * @param  pdata: data pointer.
+  * @retval read status:
+  *         - 0: data successfully read
+  *         - 1: failed to read data
+  */
+uint16_t flash_ee_partition_read(ee_partition_type* partition, uint16_t address, uint16_t* pdata)
+{
+#if (EE_THREAD_SAFE > 0)
+  uint16_t data = 0;
+  uint16_t read_status;
+  uint32_t seq;
+
+  /* no lock, the lookup is repeated when a writer published a change during it */
+  do
+  {
+    seq = ee_publish_seq;
+    __DMB();
+
+    read_status = flash_ee_partition_lookup(partition, address, &data, (uint16_t)(seq & 1));
+
+    __DMB();
+  } while (seq != ee_publish_seq);
+
+  if (read_status == 0)
+  {
+    *pdata = data;
+  }
+
+  return read_status;
+#else
+  return flash_ee_partition_lookup(partition, address, pdata, 0);
+#endif
+}
+
+#if (EE_RECORD_INVALIDATE > 0)
+/** 
+  * @brief  count the live and dead records of the valid page of a partition, the dead
+  *         ones are reclaimed by its next transfer.
+  * @param  partition: eeprom partition.
+  * @param  plive: number of live records pointer.
+  * @param  pdead: number of superseded records pointer.
+  * @retval number of free record slots.
+  */
+uint16_t flash_ee_partition_usage(ee_partition_type* partition, uint16_t* plive, uint16_t* pdead)
+{
+  uint16_t slot;
+  uint16_t next_slot;
+  uint16_t valid_page;
+  uint16_t data_address;
+  uint32_t page_address;
+
+  *plive = 0;
+  *pdead = 0;
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return 0;
+  }
+
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+  next_slot    = flash_ee_page_next_slot(partition, page_address);
+
+  for (slot = 1; slot < next_slot; slot++)
+  {
+    data_address = EE_SLOT_ADDRESS(page_address, slot);
+
+    if (data_address == EE_ADDRESS_DEAD)
+    {
+      (*pdead)++;
+    }
+    else if (EE_RECORD_KEY(data_address))
+    {
+      (*plive)++;
+    }
+  }
+
+  return (uint16_t)(EE_PAGE_RECORD_END(partition, page_address) / 4) - next_slot;
+}
+#endif
+
+/** 
+  * @brief  read data from the eeprom.
+  * @param  address: variable address.
+  * @param  pdata: data pointer.
+  * @retval read status:
+  *         - 0: data successfully read
+  *         - 1: failed to read data
+  */
+uint16_t flash_ee_data_read(uint16_t address, uint16_t* pdata)
+{
+  return flash_ee_partition_read(&ee_default_partition, address, pdata);
+}
+
+/** 
+  * @brief  read variables 0 to count - 1 from the eeprom in a single pass.
+  *         the valid page is scanned once from the newest record backwards and the
+  *         first record found for each variable is kept, so loading many variables
+  *         costs one page scan instead of one scan per variable.
+  * @param  values: data array, indexed by variable address.
+  * @param  present: flag array, set to 1 for every variable found, 0 otherwise.
+  * @param  count: number of variables, starting from address 0.
+  * @retval number of variables found, 0 when the deferred init fails.
+  */
+uint16_t flash_ee_read_all(uint16_t* values, uint8_t* present, uint16_t count)
+{
+  uint16_t i;
+  uint16_t found = 0;
+  uint16_t valid_page;
+  uint16_t data_address;
+  uint32_t find_address;
+  uint32_t start_address;
+
+  for (i = 0; i < count; i++)
+  {
+    present[i] = 0;
+  }
+
+  /* a pass over all variables completes the deferred init first, none is found when it fails */
+  if (flash_ee_init_finish() != FMC_STATUS_COMPLETE)
+  {
+    return 0;
+  }
+
+  ee_write_begin();
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(&ee_default_partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    ee_write_end(&ee_default_partition);
+
+    return 0;
+  }
+
+  /* start address calculation */
+  start_address = ee_default_partition.base_address + valid_page * ee_default_partition.page_size + 4;
+
+  /* find address calculation */
+  find_address  = start_address - 4 + EE_PAGE_RECORD_END(&ee_default_partition, start_address - 4) - 2;
+
+  while ((find_address > start_address) && (found < count))
+  {
+    /* read variable address */
+    data_address = (*(__IO uint16_t*)find_address);
+
+    /* keep the newest record of each requested variable */
+    if (EE_RECORD_KEY(data_address) && (data_address < count) && (present[data_address] == 0))
+    {
+      values[data_address]  = flash_ee_record_data(&ee_default_partition, find_address - 2);
+      present[data_address] = 1;
+      found++;
+    }
+
+    /* find address - 4 */
+    find_address -= 4;
+  }
+
+#if (EE_HOT_KEYS > 0)
+  /* the hot page holds the newest data of the hot variables */
+  for (i = 0; i < EE_HOT_KEYS; i++)
+  {
+    if ((ee_hot_slot[i] != 0) && (ee_hot_key[i] < count))
+    {
+      if (present[ee_hot_key[i]] == 0)
+      {
+        present[ee_hot_key[i]] = 1;
+        found++;
+      }
+
+      values[ee_hot_key[i]] = flash_ee_record_data(&ee_hot_partition, ee_hot_page + ee_hot_slot[i] * 4);
+    }
+  }
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+  /* the packed records from the newest one, the first one of a variable is its newest data */
+  for (find_address = start_address - 4 + flash_ee_page_packed_start(&ee_default_partition, start_address - 4);
+       find_address < start_address - 4 + ee_default_partition.page_size; find_address += 2)
+  {
+    data_address = (*(__IO uint16_t*)find_address) >> 8;
+
+    if (data_address >= EE_PACKED_KEYS)
+    {
+      continue;
+    }
+
+    data_address += EE_PACKED_BASE_ADDRESS;
+
+    if ((data_address < count) && (present[data_address] == 0))
+    {
+      values[data_address]  = (*(__IO uint16_t*)find_address) & 0xFF;
+      present[data_address] = 1;
+      found++;
+    }
+  }
+#endif
+
+  ee_write_end(&ee_default_partition);
+
+  return found;
+}
+
+/** 
+  * @brief  start iterating over the live variables of the eeprom.
+  * @param  iterator: cursor to initialize.
+  * @retval none
+  */
+void flash_ee_iterator_init(ee_iterator_type* iterator)
+{
+  uint16_t i;
+  uint16_t valid_page;
+
+  /* a pass over all variables completes the deferred init first */
+  flash_ee_init_finish();
+
+  ee_write_begin();
+
+  for (i = 0; i < (EE_PARA_MAX_NUMBER + 31) / 32; i++)
+  {
+    iterator->seen[i] = 0;
+  }
+
+#if (EE_HOT_KEYS > 0)
+  iterator->hot_entry = 0;
+#endif
+
+#if (EE_PACKED_KEYS > 0)
+  for (i = 0; i < (EE_PACKED_KEYS + 31) / 32; i++)
+  {
+    iterator->packed_seen[i] = 0;
+  }
+#endif
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(&ee_default_partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    /* nothing to iterate */
+    iterator->page_address = 0;
+    iterator->find_address = 0;
+
+    ee_write_end(&ee_default_partition);
+
+    return;
+  }
+
+  iterator->page_address = ee_default_partition.base_address + valid_page * ee_default_partition.page_size;
+
+  /* start from the newest record, the last variable address of the page */
+  iterator->find_address = iterator->page_address + EE_PAGE_RECORD_END(&ee_default_partition, iterator->page_address) - 2;
+
+#if (EE_PACKED_KEYS > 0)
+  /* then the packed records from the newest one */
+  iterator->packed_address = iterator->page_address + flash_ee_page_packed_start(&ee_default_partition, iterator->page_address);
+#endif
+
+  ee_write_end(&ee_default_partition);
+}
+
+/** 
+  * @brief  move an iterator to the next live variable, run by flash_ee_iterator_next
+  *         inside a writer window.
+  * @param  iterator: cursor initialized by flash_ee_iterator_init.
+  * @param  paddress: variable address pointer.
+  * @param  pdata: data pointer.
+  * @retval iterate status, as flash_ee_iterator_next.
+  */
+uint16_t flash_ee_iterator_step(ee_iterator_type* iterator, uint16_t* paddress, uint16_t* pdata)
+{
+  uint16_t data_address;
+  uint32_t find_address;
+  uint32_t check_address;
+  uint32_t start_address;
+  uint32_t end_address;
+#if (EE_HOT_KEYS > 0)
+  uint16_t i;
+#endif
+
+  if (iterator->page_address == 0)
+  {
+    return 1;
+  }
+
+  /* a page transfer happened since the cursor was started */
+  if ((*(__IO uint16_t*)iterator->page_address) != EE_PAGE_VALID)
+  {
+    return EE_VALID_PAGE_NONE;
+  }
+
+#if (EE_HOT_KEYS > 0)
+  /* the hot variables come first, from their newest record in the hot page */
+  while (iterator->hot_entry < EE_HOT_KEYS)
+  {
+    i = iterator->hot_entry++;
+
+    if (ee_hot_slot[i] != 0)
+    {
+      *paddress = ee_hot_key[i];
+      *pdata    = flash_ee_record_data(&ee_hot_partition, ee_hot_page + ee_hot_slot[i] * 4);
+
+      return 0;
+    }
+  }
+#endif
+
+  /* start address calculation */
+  start_address = iterator->page_address + 4;
+
+  /* end address calculation */
+  end_address   = iterator->page_address + EE_PAGE_RECORD_END(&ee_default_partition, iterator->page_address) - 2;
+
+  while (iterator->find_address > start_address)
+  {
+    /* read variable address */
+    find_address = iterator->find_address;
+    data_address = (*(__IO uint16_t*)find_address);
+
+    /* find address - 4 */
+    iterator->find_address -= 4;
+
+    /* skip empty locations */
+    if (!EE_RECORD_KEY(data_address))
+    {
+      continue;
+    }
+
+#if (EE_HOT_KEYS > 0)
+    /* hot variables were returned from the hot page */
+    if (flash_ee_hot_find(data_address) != EE_HOT_KEYS)
+    {
+      continue;
+    }
+#endif
+
+    if (data_address < EE_PARA_MAX_NUMBER)
+    {
+      /* skip variables already returned */
+      if ((iterator->seen[data_address >> 5] & (1UL << (data_address & 31))) != 0)
+      {
+        continue;
+      }
+
+      iterator->seen[data_address >> 5] |= (1UL << (data_address & 31));
+    }
+    else
+    {
+      /* addresses outside the bitmap are new unless a newer record follows */
+      for (check_address = find_address + 4; check_address <= end_address; check_address += 4)
+      {
+        if ((*(__IO uint16_t*)check_address) == data_address)
+        {
+          break;
+        }
+      }
+
+      if (check_address <= end_address)
+      {
+        continue;
+      }
+    }
+
+    *paddress = data_address;
+    *pdata    = flash_ee_record_data(&ee_default_partition, find_address - 2);
+
+    return 0;
+  }
+
+#if (EE_PACKED_KEYS > 0)
+  while (iterator->packed_address < iterator->page_address + ee_default_partition.page_size)
+  {
+    /* read packed key */
+    find_address = iterator->packed_address;
+    data_address = (*(__IO uint16_t*)find_address) >> 8;
+
+    /* find address + 2 */
+    iterator->packed_address += 2;
+
+    /* skip variables already returned */
+    if ((data_address >= EE_PACKED_KEYS) || ((iterator->packed_seen[data_address >> 5] & (1UL << (data_address & 31))) != 0))
+    {
+      continue;
+    }
+
+    iterator->packed_seen[data_address >> 5] |= (1UL << (data_address & 31));
+
+    *paddress = EE_PACKED_BASE_ADDRESS + data_address;
+    *pdata    = (*(__IO uint16_t*)find_address) & 0xFF;
+
+    return 0;
+  }
+#endif
+
+  return 1;
+}
+
+/** 
+  * @brief  get the next live variable, newest data only, each variable is returned once.
+  * @param  iterator: cursor initialized by flash_ee_iterator_init.
+  * @param  paddress: variable address pointer.
+  * @param  pdata: data pointer.
+  * @retval iterate status:
+  *         - 0: a variable is returned
+  *         - 1: all variables have been returned
+  *         - EE_VALID_PAGE_NONE: the valid page changed, the cursor must be restarted
+  */
+uint16_t flash_ee_iterator_next(ee_iterator_type* iterator, uint16_t* paddress, uint16_t* pdata)
+{
+  uint16_t iterate_status;
+
+  ee_write_begin();
+
+  iterate_status = flash_ee_iterator_step(iterator, paddress, pdata);
+
+  ee_write_end(&ee_default_partition);
+
+  return iterate_status;
+}
+
+#if (EE_GROUP_COMMIT > 0)
+/** 
+  * @brief  get a halfword of a struct field, low byte first.
+  * @param  field: struct field.
+  * @param  bytes: struct bytes.
+  * @param  index: halfword of the field.
+  * @retval halfword, the high byte of the last halfword of an odd width is 0.
+  */
+uint16_t flash_ee_field_get(const ee_field_type* field, const uint8_t* bytes, uint16_t index)
+{
+  uint16_t data;
+
+  bytes += field->offset + index * 2;
+  data   = bytes[0];
+
+  if (index * 2 + 1 < field->size)
+  {
+    data |= (uint16_t)bytes[1] << 8;
+  }
+
+  return data;
+}
+
+/** 
+  * @brief  set a halfword of a struct field, low byte first.
+  * @param  field: struct field.
+  * @param  bytes: struct bytes.
+  * @param  index: halfword of the field.
+  * @param  data: halfword.
+  * @retval none
+  */
+void flash_ee_field_set(const ee_field_type* field, uint8_t* bytes, uint16_t index, uint16_t data)
+{
+  bytes += field->offset + index * 2;
+  bytes[0] = (uint8_t)data;
+
+  if (index * 2 + 1 < field->size)
+  {
+    bytes[1] = (uint8_t)(data >> 8);
+  }
+}
+
+/** 
+  * @brief  register a struct layout. every field must lie inside the struct and its
+  *         variables inside the eeprom address range, outside the packed variables.
+  *         flash_ee_struct_load must be called once before the first save.
+  * @param  layout: struct layout to fill.
+  * @param  fields: field table, kept by the layout.
+  * @param  field_num: number of fields.
+  * @param  image: size bytes of ram for the last committed struct.
+  * @param  size: struct size in bytes.
+  * @retval flash status, FMC_STATUS_ERROR_PG when a field is invalid.
+  */
+FMC_STATUS_T flash_ee_struct_register(ee_struct_type* layout, const ee_field_type* fields, uint16_t field_num, void* image, uint16_t size)
+{
+  uint16_t i;
+  uint32_t last_address;
+
+  for (i = 0; i < field_num; i++)
+  {
+    last_address = (uint32_t)fields[i].address + (fields[i].size + 1) / 2 - 1;
+
+    if ((fields[i].size == 0) || ((uint32_t)fields[i].offset + fields[i].size > size) ||
+        (fields[i].address < ee_default_partition.address_min) || (last_address > ee_default_partition.address_max))
+    {
+      return FMC_STATUS_ERROR_PG;
+    }
+
+#if (EE_PACKED_KEYS > 0)
+    if ((last_address >= EE_PACKED_BASE_ADDRESS) && (fields[i].address < EE_PACKED_BASE_ADDRESS + EE_PACKED_KEYS))
+    {
+      return FMC_STATUS_ERROR_PG;
+    }
+#endif
+  }
+
+  layout->fields    = fields;
+  layout->field_num = field_num;
+  layout->size      = size;
+  layout->image     = (uint8_t*)image;
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/** 
+  * @brief  load a struct in one pass over the valid page, from the oldest record to the
+  *         newest so that the last record of a variable is kept. fields without records
+  *         keep the value they have in data, so defaults can be set before the call.
+  *         the struct variables must not be written with flash_ee_data_write.
+  * @param  layout: registered struct layout.
+  * @param  data: struct to fill, copied to the image.
+  * @retval flash status:
+  *         - FMC_STATUS_COMPLETE: the struct was loaded
+  *         - FMC_STATUS_ERROR_PG: no valid page
+  *         - else the status of the deferred init, data is left as it is
+  */
+FMC_STATUS_T flash_ee_struct_load(ee_struct_type* layout, void* data)
+{
+  uint16_t i;
+  uint16_t slot;
+  uint16_t next_slot;
+  uint16_t valid_page;
+  uint16_t data_address;
+  uint32_t page_address;
+  const ee_field_type* field;
+  FMC_STATUS_T flash_status;
+
+  /* a pass over all variables completes the deferred init first */
+  if ((flash_status = flash_ee_init_finish()) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  ee_write_begin();
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(&ee_default_partition, EE_VALID_PAGE_READ);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    ee_write_end(&ee_default_partition);
+
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  /* page address calculation */
+  page_address = ee_default_partition.base_address + valid_page * ee_default_partition.page_size;
+  next_slot    = flash_ee_page_next_slot(&ee_default_partition, page_address);
+
+  for (slot = 1; slot < next_slot; slot++)
+  {
+    data_address = EE_SLOT_ADDRESS(page_address, slot);
+
+    /* skip empty locations and group headers */
+    if (!EE_RECORD_KEY(data_address))
+    {
+      continue;
+    }
+
+    for (i = 0, field = layout->fields; i < layout->field_num; i++, field++)
+    {
+      if ((uint16_t)(data_address - field->address) < (field->size + 1) / 2)
+      {
+        flash_ee_field_set(field, (uint8_t*)data, data_address - field->address, flash_ee_record_data(&ee_default_partition, page_address + slot * 4));
+        break;
+      }
+    }
+  }
+
+  /* the loaded struct is the committed one */
+  for (i = 0; i < layout->size; i++)
+  {
+    layout->image[i] = ((uint8_t*)data)[i];
+  }
+
+  ee_write_end(&ee_default_partition);
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/** 
+  * @brief  get the free record slots of the valid page of a partition.
+  * @param  partition: eeprom partition.
+  * @retval number of records that can still be appended.
+  */
+uint16_t flash_ee_page_room(ee_partition_type* partition)
+{
+  uint16_t next_slot;
+  uint16_t end_slot;
+  uint16_t valid_page;
+  uint32_t page_address;
+
+  /* get the valid page */
+  valid_page = flash_ee_valid_page_get(partition, EE_VALID_PAGE_WRITE);
+
+  if (valid_page == EE_VALID_PAGE_NONE)
+  {
+    return 0;
+  }
+
+  /* page address calculation */
+  page_address = partition->base_address + valid_page * partition->page_size;
+  next_slot    = flash_ee_page_next_slot(partition, page_address);
+
+#if (EE_PACKED_KEYS > 0)
+  /* an erased halfword stays below the packed records */
+  end_slot     = (uint16_t)((flash_ee_page_packed_start(partition, page_address) - 2) / 4);
+#else
+  end_slot     = (uint16_t)(EE_PAGE_RECORD_END(partition, page_address) / 4);
+#endif
+
+  return (end_slot > next_slot) ? (end_slot - next_slot) : 0;
+}
+
+#if (EE_RECORD_INVALIDATE > 0)
+/** 
+  * @brief  mark the records a complete group supersedes dead, as a write does. until the
+  *         group is complete they stay live, a rollback drops the group and keeps them.
+  * @param  layout: registered struct layout, its image is the struct before the group.
+  * @param  bytes: struct saved by the group.
+  * @param  page_address: page holding the group.
+  * @param  first_slot: first slot of the group, its header when it has one.
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_group_invalidate(ee_struct_type* layout, const uint8_t* bytes, uint32_t page_address, uint16_t first_slot)
+{
+  uint16_t i;
+  uint16_t j;
+  uint16_t slot;
+  uint16_t data_address;
+  const ee_field_type* field;
+  FMC_STATUS_T flash_status;
+
+  /* one pass over the records older than the group */
+  for (slot = first_slot - 1; slot > 0; slot--)
+  {
+    data_address = EE_SLOT_ADDRESS(page_address, slot);
+
+    if (!EE_RECORD_KEY(data_address))
+    {
+      continue;
+    }
+
+    for (i = 0, field = layout->fields; i < layout->field_num; i++, field++)
+    {
+      j = data_address - field->address;
+
+      if (j < (field->size + 1) / 2)
+      {
+        /* only the halfwords the group wrote are superseded */
+        if ((flash_ee_field_get(field, bytes, j) != flash_ee_field_get(field, layout->image, j)) &&
+            ((flash_status = ee_halfword_program(page_address + slot * 4 + 2, EE_ADDRESS_DEAD)) != FMC_STATUS_COMPLETE))
+        {
+          return flash_status;
+        }
+
+        break;
+      }
+    }
+  }
+
+  return FMC_STATUS_COMPLETE;
+}
+#endif
+
+/** 
+  * @brief  drop a group whose save failed after some of it was programmed: the valid
+  *         page is transferred without the group and the index is rebuilt on the new
+  *         page. when the transfer fails too, reads stop at the group header and the
+  *         deferred init runs again before the next write, its transfer drops the group.
+  * @param  header_address: first slot of the group, its header when it has one.
+  * @param  flash_status: status of the failed program.
+  * @retval flash_status of the failed program.
+  */
+FMC_STATUS_T flash_ee_group_rollback(uint32_t header_address, FMC_STATUS_T flash_status)
+{
+#if (EE_INDEX_BITS > 0)
+  uint16_t valid_page;
+#endif
+
+  /* nothing of the group reached the page */
+  if ((*(__IO uint32_t*)header_address) == 0xFFFFFFFF)
+  {
+    return flash_status;
+  }
+
+  ee_group_failed = header_address;
+
+#if (EE_INDEX_BITS > 0)
+  /* the index holds records of the group */
+  ee_index_state = EE_INDEX_INVALID;
+#endif
+
+  if (flash_ee_group_check(&ee_default_partition) != FMC_STATUS_COMPLETE)
+  {
+    ee_init_step = EE_INIT_COLD;
+
+    return flash_status;
+  }
+
+#if (EE_INDEX_BITS > 0)
+  valid_page = flash_ee_valid_page_get(&ee_default_partition, EE_VALID_PAGE_READ);
+
+  if (valid_page != EE_VALID_PAGE_NONE)
+  {
+    flash_ee_index_check(&ee_default_partition, ee_default_partition.base_address + valid_page * ee_default_partition.page_size);
+  }
+#endif
+
+  return flash_status;
+}
+
+/** 
+  * @brief  write the changed halfwords of a struct as one group: a header holding their
+  *         number, then one record each in the following slots. a single changed
+  *         halfword needs no header. the group goes to one page, which is transferred
+  *         first when it has no room left. a failed program rolls the group back.
+  * @param  layout: registered struct layout.
+  * @param  bytes: struct to save.
+  * @param  count: number of changed halfwords.
+  * @retval flash status, FMC_STATUS_ERROR_PG when the group does not fit in a page.
+  */
+FMC_STATUS_T flash_ee_group_write(ee_struct_type* layout, const uint8_t* bytes, uint16_t count)
+{
+  uint16_t i;
+  uint16_t j;
+  uint16_t slot;
+  uint16_t first_slot;
+  uint16_t record[2];
+  uint16_t valid_page;
+  uint32_t page_address;
+  const ee_field_type* field;
+  FMC_STATUS_T flash_status;
+
+  /* check if the page is full, when the page is full, transfer the data to erase page */ 
+  if ((flash_status = flash_ee_full_check(&ee_default_partition)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  if (flash_ee_page_room(&ee_default_partition) < count + (count > 1))
+  {
+    /* a transfer frees the superseded records */
+    if ((flash_status = flash_ee_copy_to_new_page(&ee_default_partition)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_status;
+    }
+
+    if (flash_ee_page_room(&ee_default_partition) < count + (count > 1))
+    {
+      return FMC_STATUS_ERROR_PG;
+    }
+  }
+
+  /* get the valid page */
+  valid_page   = flash_ee_valid_page_get(&ee_default_partition, EE_VALID_PAGE_WRITE);
+
+  /* page address calculation */
+  page_address = ee_default_partition.base_address + valid_page * ee_default_partition.page_size;
+  slot         = flash_ee_page_next_slot(&ee_default_partition, page_address);
+  first_slot   = slot;
+
+  if (count > 1)
+  {
+    record[0] = count;
+    record[1] = EE_ADDRESS_GROUP;
+
+    /* group header, the count is programmed before the reserved variable address */
+    if ((flash_status = ee_buffer_program(page_address + slot * 4, record, 2)) != FMC_STATUS_COMPLETE)
+    {
+      return flash_ee_group_rollback(page_address + first_slot * 4, flash_status);
+    }
+
+    slot++;
+  }
+
+  for (i = 0, field = layout->fields; i < layout->field_num; i++, field++)
+  {
+    for (j = 0; j < (field->size + 1) / 2; j++)
+    {
+      record[0] = flash_ee_field_get(field, bytes, j);
+      record[1] = field->address + j;
+
+      if (record[0] == flash_ee_field_get(field, layout->image, j))
+      {
+        continue;
+      }
+
+      /* write data and then variable address to flash */
+      if ((flash_status = ee_buffer_program(page_address + slot * 4, record, 2)) != FMC_STATUS_COMPLETE)
+      {
+        /* a single record is a plain write, the records of a group go together */
+        return (count > 1) ? flash_ee_group_rollback(page_address + first_slot * 4, flash_status) : flash_status;
+      }
+
+#if (EE_INDEX_BITS > 0)
+      /* keep the index on the newest record */
+      flash_ee_index_append(field->address + j, slot, page_address);
+#endif
+
+      slot++;
+    }
+  }
+
+#if (EE_RECORD_INVALIDATE > 0)
+  /* the group is complete, the records it supersedes are dead */
+  if ((flash_status = flash_ee_group_invalidate(layout, bytes, page_address, first_slot)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+#endif
+
+  /* check if the page is full, when the page is full, transfer the data to erase page */ 
+  return flash_ee_full_check(&ee_default_partition);
+}
+
+/** 
+  * @brief  save a struct. the halfwords that differ from the image are committed as one
+  *         group: after a reset either all of them or none of them are read back.
+  * @param  layout: registered struct layout, loaded once.
+  * @param  data: struct to save, copied to the image once committed.
+  * @retval flash status.
+  */
+FMC_STATUS_T flash_ee_struct_save(ee_struct_type* layout, const void* data)
+{
+  uint16_t i;
+  uint16_t j;
+  uint16_t count = 0;
+#if (EE_TRACE_EVENTS > 0)
+  uint16_t unchanged = 0;
+#endif
+  const ee_field_type* field;
+  FMC_STATUS_T flash_status;
+
+  /* a write completes the deferred init first */
+  if ((flash_status = flash_ee_init_finish()) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  ee_write_begin();
+
+  /* diff against the last committed struct */
+  for (i = 0, field = layout->fields; i < layout->field_num; i++, field++)
+  {
+    for (j = 0; j < (field->size + 1) / 2; j++)
+    {
+      if (flash_ee_field_get(field, (const uint8_t*)data, j) != flash_ee_field_get(field, layout->image, j))
+      {
+        count++;
+      }
+#if (EE_TRACE_EVENTS > 0)
+      else
+      {
+        unchanged++;
+      }
+#endif
+    }
+  }
+
+#if (EE_TRACE_EVENTS > 0)
+  if (unchanged != 0)
+  {
+    ee_trace(EE_TRACE_ELIDED, 0, layout->fields->address, unchanged);
+  }
+#endif
+
+  if (count == 0)
+  {
+    ee_write_end(&ee_default_partition);
+
+    return FMC_STATUS_COMPLETE;
+  }
+
+#if (EE_CAPTURE_BYTES > 0)
+  /* the group, then the halfwords it writes */
+  ee_capture(EE_CAPTURE_GROUP, layout->fields->address, count);
+
+  for (i = 0, field = layout->fields; i < layout->field_num; i++, field++)
+  {
+    for (j = 0; j < (field->size + 1) / 2; j++)
+    {
+      if (flash_ee_field_get(field, (const uint8_t*)data, j) != flash_ee_field_get(field, layout->image, j))
+      {
+        ee_capture(EE_CAPTURE_WRITE, field->address + j, flash_ee_field_get(field, (const uint8_t*)data, j));
+      }
+    }
+  }
+#endif
+
+  /* flash unlock */
+  ee_unlock();
+
+  /* a failed group is rolled back, the image stays on the last committed struct */
+  if ((flash_status = flash_ee_group_write(layout, (const uint8_t*)data, count)) == FMC_STATUS_COMPLETE)
+  {
+    /* the saved struct is the committed one */
+    for (i = 0; i < layout->size; i++)
+    {
+      layout->image[i] = ((const uint8_t*)data)[i];
+    }
+  }
+
+  /* flash lock */
+  ee_lock();
+
+  ee_write_end(&ee_default_partition);
+
+  ee_trace(EE_TRACE_GROUP, flash_status, layout->fields->address, count);
+
+  return flash_status;
+}
+#endif
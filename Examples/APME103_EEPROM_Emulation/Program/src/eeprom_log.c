@@ -0,0 +1,598 @@
+/**
+  **************************************************************************
+  * @file     eeprom_log.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    the append only log partition of the flash eeprom
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include "eeprom_log.h"
+#include "eeprom_trace.h"
+
+/*!< storage backend operations */
+#if (EE_BACKEND == EE_BACKEND_FMC)
+#define ee_unlock()                     FMC_Unlock()
+#define ee_lock()                       FMC_Lock()
+#define ee_halfword_program(addr, data) ee_traced(FMC_ProgramHalfWord(addr, data), addr)
+#define ee_buffer_program(addr, data, count) ee_traced(FMC_ProgramBuffer(addr, data, count), addr)
+#define ee_range_erase(addr, num, fail) ee_traced(FMC_EraseRange(addr, num, fail), addr)
+#else
+#define ee_unlock()                     flash_ee_nor_unlock()
+#define ee_lock()                       flash_ee_nor_lock()
+#define ee_halfword_program(addr, data) ee_traced(flash_ee_nor_halfword_program(addr, data), addr)
+#define ee_buffer_program(addr, data, count) ee_traced(flash_ee_nor_buffer_program(addr, data, count), addr)
+#define ee_range_erase(addr, num, fail) ee_traced(flash_ee_nor_range_erase(addr, num, fail), addr)
+#endif
+
+#define EE_LOG_RUN                      16                  /*!< data halfwords an append programs in one run */
+
+#define EE_LOG_PAGE_ADDRESS(log, page)  ((log)->base_address + (uint32_t)(page) * (log)->page_size)
+#define EE_LOG_HALFWORD(address)        (*(__IO uint16_t*)(address))
+
+/**
+  * @brief  get the sequence number of the first entry of a sector.
+  * @param  log: log partition.
+  * @param  page: sector of the ring.
+  * @retval sequence number.
+  */
+uint32_t flash_ee_log_page_seq(ee_log_type* log, uint16_t page)
+{
+  uint32_t page_address = EE_LOG_PAGE_ADDRESS(log, page);
+
+  return EE_LOG_HALFWORD(page_address) | ((uint32_t)EE_LOG_HALFWORD(page_address + 2) << 16);
+}
+
+/**
+  * @brief  walk the entries of a sector, the newest complete entry found becomes the
+  *         newest entry of the log.
+  * @param  log: log partition.
+  * @param  page: sector of the ring.
+  * @param  pend: returns the offset of the first free byte, the sector size when a
+  *         damaged length ends it.
+  * @retval sequence number following the last entry of the sector.
+  */
+uint32_t flash_ee_log_page_scan(ee_log_type* log, uint16_t page, uint32_t* pend)
+{
+  uint32_t page_address = EE_LOG_PAGE_ADDRESS(log, page);
+  uint32_t offset = EE_LOG_HEADER_SIZE;
+  uint32_t seq = flash_ee_log_page_seq(log, page);
+  uint32_t entry_size;
+  uint16_t length;
+
+  while (offset + EE_LOG_ENTRY_SIZE(0) <= log->page_size)
+  {
+    if ((length = EE_LOG_HALFWORD(page_address + offset)) == 0xFFFF)
+    {
+      break;
+    }
+
+    entry_size = EE_LOG_ENTRY_SIZE(length);
+
+    if (offset + entry_size > log->page_size)
+    {
+      /* nothing after a damaged length is used */
+      offset = log->page_size;
+      break;
+    }
+
+    if (EE_LOG_HALFWORD(page_address + offset + entry_size - 2) == EE_LOG_COMMIT)
+    {
+      log->last_address = page_address + offset;
+      log->last_seq     = seq;
+    }
+
+    seq++;
+    offset += entry_size;
+  }
+
+  *pend = offset;
+
+  return seq;
+}
+
+/**
+  * @brief  open a sector as the head of the log, erasing it first when it holds data,
+  *         the entries of a reclaimed sector are dropped.
+  * @param  log: log partition.
+  * @param  page: sector of the ring.
+  * @param  seq: sequence number of the first entry of the sector.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_log_page_open(ee_log_type* log, uint16_t page, uint32_t seq)
+{
+  uint32_t page_address = EE_LOG_PAGE_ADDRESS(log, page);
+  __IO uint32_t* find_address = (__IO uint32_t*)page_address;
+  __IO uint32_t* end_address  = (__IO uint32_t*)(page_address + log->page_size);
+  uint16_t header[4];
+  FMC_STATUS_T flash_status;
+
+  if (log->last_address - page_address < log->page_size)
+  {
+    log->last_address = 0;
+  }
+
+  /* a reclaimed sector, or one left by a reset while it was opened */
+  while ((find_address < end_address) && (*find_address == 0xFFFFFFFF))
+  {
+    find_address++;
+  }
+
+  if ((find_address < end_address) &&
+      ((flash_status = ee_range_erase(page_address, 1, NULL)) != FMC_STATUS_COMPLETE))
+  {
+    return flash_status;
+  }
+
+  /* the mark goes last, a sector without it is not part of the log */
+  header[0] = (uint16_t)seq;
+  header[1] = (uint16_t)(seq >> 16);
+  header[2] = 0xFFFF;
+  header[3] = EE_LOG_PAGE_MARK;
+
+  if ((flash_status = ee_buffer_program(page_address, header, 4)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  log->head_page   = page;
+  log->head_offset = EE_LOG_HEADER_SIZE;
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/**
+  * @brief  copy an entry out of the log.
+  * @param  entry_address: entry address.
+  * @param  ptimestamp: returns the timestamp, can be NULL.
+  * @param  data: receives up to size data bytes.
+  * @param  size: size of the data buffer.
+  * @param  plength: returns the data bytes of the entry, can be NULL.
+  * @retval none
+  */
+void flash_ee_log_entry_read(uint32_t entry_address, uint32_t* ptimestamp, void* data, uint16_t size, uint16_t* plength)
+{
+  uint8_t* bytes = (uint8_t*)data;
+  uint16_t length = EE_LOG_HALFWORD(entry_address);
+  uint16_t i, halfword;
+
+  if (ptimestamp != NULL)
+  {
+    *ptimestamp = EE_LOG_HALFWORD(entry_address + 2) | ((uint32_t)EE_LOG_HALFWORD(entry_address + 4) << 16);
+  }
+
+  if (plength != NULL)
+  {
+    *plength = length;
+  }
+
+  if (size > length)
+  {
+    size = length;
+  }
+
+  for (i = 0; i < size; i += 2)
+  {
+    halfword = EE_LOG_HALFWORD(entry_address + 6 + i);
+
+    bytes[i] = (uint8_t)halfword;
+
+    if (i + 1 < size)
+    {
+      bytes[i + 1] = (uint8_t)(halfword >> 8);
+    }
+  }
+}
+
+/**
+  * @brief  set up a log partition and find its head. the sector headers give the ring
+  *         order, only the head sector is walked.
+  * @param  log: log partition.
+  * @param  base_address: sector 0 address, sector aligned. the sectors follow it.
+  * @param  page_num: sectors of the ring, 2 at least.
+  * @param  entry_size: data bytes of every entry, 0 for variable size entries. fixed
+  *         size entries let flash_ee_log_seek compute their place in a sector.
+  * @retval flash status, FMC_STATUS_ERROR_PG when the geometry is invalid.
+  */
+FMC_STATUS_T flash_ee_log_init(ee_log_type* log, uint32_t base_address, uint16_t page_num, uint16_t entry_size)
+{
+  uint32_t page_address, seq, head_seq = 0, tail_seq = 0;
+  uint16_t page, found = 0;
+  FMC_STATUS_T flash_status;
+
+  if ((page_num < 2) || ((base_address % EE_SECTOR_SIZE) != 0) ||
+      (EE_LOG_ENTRY_SIZE(entry_size) > EE_SECTOR_SIZE - EE_LOG_HEADER_SIZE))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  log->base_address = base_address;
+  log->page_size    = EE_SECTOR_SIZE;
+  log->page_num     = page_num;
+  log->entry_size   = entry_size;
+  log->head_page    = 0;
+  log->tail_page    = 0;
+  log->last_address = 0;
+  log->last_seq     = 0;
+  log->next_seq     = 0;
+
+  /* the opened sectors follow each other in ring order, the head has the highest sequence */
+  for (page = 0; page < page_num; page++)
+  {
+    page_address = EE_LOG_PAGE_ADDRESS(log, page);
+
+    if (EE_LOG_HALFWORD(page_address + 6) != EE_LOG_PAGE_MARK)
+    {
+      continue;
+    }
+
+    seq = flash_ee_log_page_seq(log, page);
+
+    if ((found == 0) || (seq > head_seq))
+    {
+      head_seq = seq;
+      log->head_page = page;
+    }
+
+    if ((found == 0) || (seq < tail_seq))
+    {
+      tail_seq = seq;
+      log->tail_page = page;
+    }
+
+    found = 1;
+  }
+
+  if (found == 0)
+  {
+    /* flash unlock */
+    ee_unlock();
+
+    flash_status = flash_ee_log_page_open(log, 0, 0);
+
+    /* flash lock */
+    ee_lock();
+
+    return flash_status;
+  }
+
+  log->next_seq = flash_ee_log_page_scan(log, log->head_page, &log->head_offset);
+
+  /* an empty head sector leaves the newest entry in the sector before it */
+  if ((log->last_address == 0) && (log->head_page != log->tail_page))
+  {
+    flash_ee_log_page_scan(log, (log->head_page + log->page_num - 1) % log->page_num, &page_address);
+  }
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/**
+  * @brief  append an entry at the head of the log. the entry costs its length and
+  *         timestamp, its data and its commit halfword, each programmed as one run.
+  * @param  log: log partition.
+  * @param  timestamp: caller time of the entry.
+  * @param  data: entry data.
+  * @param  size: data bytes, entry_size for a log of fixed size entries.
+  * @retval flash_status, FMC_STATUS_ERROR_PG when the size does not fit the log.
+  */
+FMC_STATUS_T flash_ee_log_append(ee_log_type* log, uint32_t timestamp, const void* data, uint16_t size)
+{
+  const uint8_t* bytes = (const uint8_t*)data;
+  uint32_t entry_size = EE_LOG_ENTRY_SIZE(size);
+  uint32_t address, data_address;
+  uint16_t run[EE_LOG_RUN];
+  uint16_t offset = 0, count, next_page;
+  FMC_STATUS_T flash_status;
+
+  if (((log->entry_size != 0) && (size != log->entry_size)) ||
+      (entry_size > log->page_size - EE_LOG_HEADER_SIZE))
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  /* flash unlock */
+  ee_unlock();
+
+  /* the head sector is full, the next sector of the ring is reclaimed */
+  if (log->head_offset + entry_size > log->page_size)
+  {
+    next_page = (log->head_page + 1) % log->page_num;
+
+    if (next_page == log->tail_page)
+    {
+      log->tail_page = (log->tail_page + 1) % log->page_num;
+    }
+
+    if ((flash_status = flash_ee_log_page_open(log, next_page, log->next_seq)) != FMC_STATUS_COMPLETE)
+    {
+      /* flash lock */
+      ee_lock();
+
+      return flash_status;
+    }
+  }
+
+  address = EE_LOG_PAGE_ADDRESS(log, log->head_page) + log->head_offset;
+
+  run[0] = size;
+  run[1] = (uint16_t)timestamp;
+  run[2] = (uint16_t)(timestamp >> 16);
+
+  flash_status = ee_buffer_program(address, run, 3);
+
+  /* the entry holds its space and sequence number from here on, a failed entry is
+     stepped over like one cut by a reset, a failed length closes the sector */
+  log->head_offset = (flash_status == FMC_STATUS_COMPLETE) ? (log->head_offset + entry_size) : log->page_size;
+  log->next_seq++;
+
+  /* the data in runs, an odd last byte padded with 0xFF */
+  data_address = address + 6;
+
+  while ((flash_status == FMC_STATUS_COMPLETE) && (offset < size))
+  {
+    for (count = 0; (count < EE_LOG_RUN) && (offset < size); count++, offset += 2)
+    {
+      run[count] = (offset + 1 < size) ? (uint16_t)(bytes[offset] | (bytes[offset + 1] << 8)) :
+                                         (uint16_t)(bytes[offset] | 0xFF00);
+    }
+
+    flash_status = ee_buffer_program(data_address, run, count);
+    data_address += (uint32_t)count * 2;
+  }
+
+  if (flash_status == FMC_STATUS_COMPLETE)
+  {
+    flash_status = ee_halfword_program(address + entry_size - 2, EE_LOG_COMMIT);
+  }
+
+  if (flash_status == FMC_STATUS_COMPLETE)
+  {
+    log->last_address = address;
+    log->last_seq     = log->next_seq - 1;
+  }
+
+  /* flash lock */
+  ee_lock();
+
+  return flash_status;
+}
+
+/**
+  * @brief  read the newest complete entry of the log, no flash is searched.
+  * @param  log: log partition.
+  * @param  pseq: returns the sequence number, can be NULL.
+  * @param  ptimestamp: returns the timestamp, can be NULL.
+  * @param  data: receives up to size data bytes.
+  * @param  size: size of the data buffer.
+  * @param  plength: returns the data bytes of the entry, can be NULL.
+  * @retval the read status:
+  *         - 0: the entry is read
+  *         - 1: the log is empty
+  */
+uint16_t flash_ee_log_tail(ee_log_type* log, uint32_t* pseq, uint32_t* ptimestamp, void* data, uint16_t size, uint16_t* plength)
+{
+  if (log->last_address == 0)
+  {
+    return 1;
+  }
+
+  if (pseq != NULL)
+  {
+    *pseq = log->last_seq;
+  }
+
+  flash_ee_log_entry_read(log->last_address, ptimestamp, data, size, plength);
+
+  return 0;
+}
+
+/**
+  * @brief  place a cursor before the entry of a sequence number, or before the oldest
+  *         entry left when that entry is reclaimed. a cursor placed at the head returns
+  *         the entries appended later.
+  * @param  log: log partition.
+  * @param  cursor: read cursor.
+  * @param  seq: sequence number.
+  * @retval the seek status:
+  *         - 0: entries at or after seq are in the log
+  *         - 1: the cursor is at the head
+  */
+uint16_t flash_ee_log_seek(ee_log_type* log, ee_log_cursor_type* cursor, uint32_t seq)
+{
+  uint32_t page_address, end, first_seq;
+  uint16_t low = 0, high, middle, length;
+
+  if (seq > log->next_seq)
+  {
+    seq = log->next_seq;
+  }
+
+  /* binary search the sectors, oldest first, for the last one starting at or before seq */
+  high = (log->head_page + log->page_num - log->tail_page) % log->page_num;
+
+  while (low < high)
+  {
+    middle = (low + high + 1) / 2;
+
+    if (flash_ee_log_page_seq(log, (log->tail_page + middle) % log->page_num) <= seq)
+    {
+      low = middle;
+    }
+    else
+    {
+      high = middle - 1;
+    }
+  }
+
+  cursor->page   = (log->tail_page + low) % log->page_num;
+  cursor->offset = EE_LOG_HEADER_SIZE;
+  cursor->seq    = first_seq = flash_ee_log_page_seq(log, cursor->page);
+
+  if (seq <= first_seq)
+  {
+    return (first_seq >= log->next_seq) ? 1 : 0;
+  }
+
+  page_address = EE_LOG_PAGE_ADDRESS(log, cursor->page);
+  end = (cursor->page == log->head_page) ? log->head_offset : log->page_size;
+
+  if (log->entry_size != 0)
+  {
+    /* fixed size entries are found without a walk */
+    cursor->offset += (seq - first_seq) * EE_LOG_ENTRY_SIZE(log->entry_size);
+    cursor->seq     = seq;
+
+    if (cursor->offset > end)
+    {
+      cursor->offset = end;
+    }
+  }
+  else
+  {
+    while ((cursor->seq < seq) && (cursor->offset + EE_LOG_ENTRY_SIZE(0) <= end))
+    {
+      if ((length = EE_LOG_HALFWORD(page_address + cursor->offset)) == 0xFFFF)
+      {
+        break;
+      }
+
+      cursor->offset += EE_LOG_ENTRY_SIZE(length);
+      cursor->seq++;
+    }
+  }
+
+  return (seq >= log->next_seq) ? 1 : 0;
+}
+
+/**
+  * @brief  place a cursor before the first entry with a timestamp at or after the given
+  *         one. the sectors are searched by the timestamp of their first entry and one
+  *         sector is walked.
+  * @param  log: log partition.
+  * @param  cursor: read cursor.
+  * @param  timestamp: timestamp.
+  * @retval the seek status:
+  *         - 0: the cursor is before such an entry
+  *         - 1: no entry is that recent, the cursor is at the head
+  */
+uint16_t flash_ee_log_seek_time(ee_log_type* log, ee_log_cursor_type* cursor, uint32_t timestamp)
+{
+  ee_log_cursor_type entry;
+  uint32_t page_address, entry_timestamp;
+  uint16_t low = 0, high, middle;
+
+  /* binary search the sectors, oldest first, for the last one whose first entry is older */
+  high = (log->head_page + log->page_num - log->tail_page) % log->page_num;
+
+  while (low < high)
+  {
+    middle = (low + high + 1) / 2;
+    page_address = EE_LOG_PAGE_ADDRESS(log, (log->tail_page + middle) % log->page_num);
+
+    if ((EE_LOG_HALFWORD(page_address + EE_LOG_HEADER_SIZE) != 0xFFFF) &&
+        ((EE_LOG_HALFWORD(page_address + EE_LOG_HEADER_SIZE + 2) |
+          ((uint32_t)EE_LOG_HALFWORD(page_address + EE_LOG_HEADER_SIZE + 4) << 16)) < timestamp))
+    {
+      low = middle;
+    }
+    else
+    {
+      high = middle - 1;
+    }
+  }
+
+  cursor->page   = (log->tail_page + low) % log->page_num;
+  cursor->offset = EE_LOG_HEADER_SIZE;
+  cursor->seq    = flash_ee_log_page_seq(log, cursor->page);
+
+  entry = *cursor;
+
+  while (flash_ee_log_next(log, &entry, NULL, &entry_timestamp, NULL, 0, NULL) == 0)
+  {
+    if (entry_timestamp >= timestamp)
+    {
+      return 0;
+    }
+
+    *cursor = entry;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  read the entry at a cursor and move the cursor past it, the entries cut by a
+  *         reset are skipped.
+  * @param  log: log partition.
+  * @param  cursor: read cursor.
+  * @param  pseq: returns the sequence number, can be NULL.
+  * @param  ptimestamp: returns the timestamp, can be NULL.
+  * @param  data: receives up to size data bytes.
+  * @param  size: size of the data buffer.
+  * @param  plength: returns the data bytes of the entry, can be NULL.
+  * @retval the read status:
+  *         - 0: the entry is read
+  *         - 1: the cursor is at the head
+  */
+uint16_t flash_ee_log_next(ee_log_type* log, ee_log_cursor_type* cursor, uint32_t* pseq, uint32_t* ptimestamp, void* data, uint16_t size, uint16_t* plength)
+{
+  uint32_t page_address, entry_address, entry_size;
+  uint16_t length;
+
+  page_address = EE_LOG_PAGE_ADDRESS(log, cursor->page);
+
+  /* the sector of the cursor was reclaimed */
+  if ((EE_LOG_HALFWORD(page_address + 6) != EE_LOG_PAGE_MARK) ||
+      (flash_ee_log_page_seq(log, cursor->page) > cursor->seq))
+  {
+    flash_ee_log_seek(log, cursor, cursor->seq);
+  }
+
+  while (1)
+  {
+    page_address = EE_LOG_PAGE_ADDRESS(log, cursor->page);
+
+    if ((cursor->page == log->head_page) && (cursor->offset >= log->head_offset))
+    {
+      return 1;
+    }
+
+    if ((cursor->offset + EE_LOG_ENTRY_SIZE(0) > log->page_size) ||
+        ((length = EE_LOG_HALFWORD(page_address + cursor->offset)) == 0xFFFF))
+    {
+      if (cursor->page == log->head_page)
+      {
+        return 1;
+      }
+
+      /* the end of a full sector, the next sector of the ring follows */
+      cursor->page   = (cursor->page + 1) % log->page_num;
+      cursor->offset = EE_LOG_HEADER_SIZE;
+      cursor->seq    = flash_ee_log_page_seq(log, cursor->page);
+      continue;
+    }
+
+    entry_address = page_address + cursor->offset;
+    entry_size    = EE_LOG_ENTRY_SIZE(length);
+
+    cursor->offset += entry_size;
+    cursor->seq++;
+
+    if ((cursor->offset <= log->page_size) &&
+        (EE_LOG_HALFWORD(entry_address + entry_size - 2) == EE_LOG_COMMIT))
+    {
+      if (pseq != NULL)
+      {
+        *pseq = cursor->seq - 1;
+      }
+
+      flash_ee_log_entry_read(entry_address, ptimestamp, data, size, plength);
+
+      return 0;
+    }
+  }
+}
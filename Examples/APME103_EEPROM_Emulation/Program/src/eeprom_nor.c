@@ -0,0 +1,288 @@
+/**
+  **************************************************************************
+  * @file     eeprom_nor.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    the external NOR/SRAM backend of the flash eeprom
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include "eeprom.h"
+
+#if (EE_BACKEND != EE_BACKEND_FMC)
+
+#define EE_NOR_DQ6                      ((uint16_t)0x0040)  /*!< toggle bit, toggles while an operation is in progress */
+#define EE_NOR_DQ5                      ((uint16_t)0x0020)  /*!< exceeded timing limits */
+
+#define EE_NOR_WREN                     ((uint32_t)0x00001000)  /*!< EMMC bank write enable bit */
+
+/** 
+  * @brief  configure the EMMC pins and the bank 1 NOR/SRAM region used by the eeprom.
+  *         data lines D0..D15, address lines A0..A18, NOE, NWE and NE1.
+  *         A19..A22 share pins with the board LEDs and are left unconfigured, so the
+  *         eeprom area must lie within the lower 1MB of the device.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_nor_init(void)
+{
+  GPIO_Config_T gpio_config;
+  EMMC_NORSRAMConfig_T emmc_config;
+  EMMC_NORSRAMTimingConfig_T timing_config;
+
+  /* enable the EMMC and gpio clocks */
+  RCM_EnableAHBPeriphClock(RCM_AHB_PERIPH_EMMC);
+  RCM_EnableAPB2PeriphClock(RCM_APB2_PERIPH_GPIOD | RCM_APB2_PERIPH_GPIOE |
+                            RCM_APB2_PERIPH_GPIOF | RCM_APB2_PERIPH_GPIOG);
+
+  gpio_config.mode  = GPIO_MODE_AF_PP;
+  gpio_config.speed = GPIO_SPEED_50MHz;
+
+  /* D0..D3, D13..D15, A16..A18, NOE, NWE, NE1 */
+  gpio_config.pin = GPIO_PIN_0  | GPIO_PIN_1  | GPIO_PIN_4  | GPIO_PIN_5  | GPIO_PIN_7  |
+                    GPIO_PIN_8  | GPIO_PIN_9  | GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12 |
+                    GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15;
+  GPIO_Config(GPIOD, &gpio_config);
+
+  /* D4..D12 */
+  gpio_config.pin = GPIO_PIN_7  | GPIO_PIN_8  | GPIO_PIN_9  | GPIO_PIN_10 | GPIO_PIN_11 |
+                    GPIO_PIN_12 | GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15;
+  GPIO_Config(GPIOE, &gpio_config);
+
+  /* A0..A9 */
+  gpio_config.pin = GPIO_PIN_0  | GPIO_PIN_1  | GPIO_PIN_2  | GPIO_PIN_3  | GPIO_PIN_4  |
+                    GPIO_PIN_5  | GPIO_PIN_12 | GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15;
+  GPIO_Config(GPIOF, &gpio_config);
+
+  /* A10..A15 */
+  gpio_config.pin = GPIO_PIN_0  | GPIO_PIN_1  | GPIO_PIN_2  | GPIO_PIN_3  | GPIO_PIN_4  |
+                    GPIO_PIN_5;
+  GPIO_Config(GPIOG, &gpio_config);
+
+  emmc_config.readWriteTimingStruct = &timing_config;
+  emmc_config.writeTimingStruct     = &timing_config;
+  EMMC_ConfigNORSRAMStructInit(&emmc_config);
+
+  emmc_config.bank            = EE_NOR_BANK;
+  emmc_config.dataAddressMux  = EMMC_DATA_ADDRESS_MUX_DISABLE;
+  emmc_config.memoryDataWidth = EMMC_MEMORY_DATA_WIDTH_16BIT;
+  emmc_config.waiteSignal     = EMMC_WAITE_SIGNAL_DISABLE;
+
+  /* writes stay disabled until the emulator unlocks the bank */
+  emmc_config.writeOperation  = EMMC_WRITE_OPERATION_DISABLE;
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+  emmc_config.memoryType      = EMMC_MEMORY_TYPE_NOR;
+  timing_config.accessMode    = EMMC_ACCESS_MODE_B;
+#else
+  emmc_config.memoryType      = EMMC_MEMORY_TYPE_SRAM;
+  timing_config.accessMode    = EMMC_ACCESS_MODE_A;
+#endif
+
+  /* asynchronous access timing, 70ns device at 120MHz HCLK */
+  timing_config.addressSetupTime  = 0x02;
+  timing_config.addressHodeTime   = 0x00;
+  timing_config.dataSetupTime     = 0x0A;
+  timing_config.busTurnaroundTime = 0x00;
+  timing_config.clockDivision     = 0x00;
+  timing_config.dataLatency       = 0x00;
+
+  EMMC_ConfigNORSRAM(&emmc_config);
+  EMMC_EnableNORSRAM(EE_NOR_BANK);
+}
+
+/** 
+  * @brief  enable writes to the EMMC bank.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_nor_unlock(void)
+{
+  EMMC_Bank1->SNCTRL_T[EE_NOR_BANK] |= EE_NOR_WREN;
+}
+
+/** 
+  * @brief  disable writes to the EMMC bank, stray stores are then ignored by the controller.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_nor_lock(void)
+{
+  EMMC_Bank1->SNCTRL_T[EE_NOR_BANK] &= ~EE_NOR_WREN;
+}
+
+/** 
+  * @brief  return the NOR device to read array mode.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_nor_reset(void)
+{
+#if (EE_BACKEND == EE_BACKEND_NOR)
+  EE_NOR_COMMAND(0x0000, 0x00F0);
+#endif
+}
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+/** 
+  * @brief  wait for the embedded program/erase algorithm of the NOR device to finish.
+  *         the device toggles DQ6 on every read while busy, DQ5 reports a timing failure.
+  * @param  address: address inside the sector being programmed or erased.
+  * @param  timeout: polling timeout.
+  * @retval flash_status
+  */
+static FMC_STATUS_T flash_ee_nor_wait(uint32_t address, uint32_t timeout)
+{
+  uint16_t status1;
+  uint16_t status2;
+
+  while (timeout--)
+  {
+    status1 = EE_NOR_READ(address);
+    status2 = EE_NOR_READ(address);
+
+    /* toggling stopped, the operation is complete */
+    if (((status1 ^ status2) & EE_NOR_DQ6) == 0)
+    {
+      return FMC_STATUS_COMPLETE;
+    }
+
+    /* timing limit exceeded, check the toggle bit once more before failing */
+    if ((status2 & EE_NOR_DQ5) != 0)
+    {
+      status1 = EE_NOR_READ(address);
+      status2 = EE_NOR_READ(address);
+
+      if (((status1 ^ status2) & EE_NOR_DQ6) == 0)
+      {
+        return FMC_STATUS_COMPLETE;
+      }
+
+      flash_ee_nor_reset();
+
+      return FMC_STATUS_ERROR_PG;
+    }
+  }
+
+  flash_ee_nor_reset();
+
+  return FMC_STATUS_TIMEOUT;
+}
+#endif
+
+/** 
+  * @brief  program a halfword of the external memory.
+  * @param  address: address to be programmed.
+  * @param  data: data.
+  * @retval flash_status
+  */
+FMC_STATUS_T flash_ee_nor_halfword_program(uint32_t address, uint16_t data)
+{
+#if (EE_BACKEND == EE_BACKEND_NOR)
+  FMC_STATUS_T flash_status;
+
+  /* word program command sequence */
+  EE_NOR_COMMAND(0x0555, 0x00AA);
+  EE_NOR_COMMAND(0x02AA, 0x0055);
+  EE_NOR_COMMAND(0x0555, 0x00A0);
+  EE_NOR_WRITE(address, data);
+
+  if ((flash_status = flash_ee_nor_wait(address, EE_NOR_PROGRAM_TIMEOUT)) != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+#else
+  EE_NOR_WRITE(address, data);
+#endif
+
+  /* NOR cannot program a 0 back to 1, the read back catches it like a FMC program error */
+  if (EE_NOR_READ(address) != data)
+  {
+    return FMC_STATUS_ERROR_PG;
+  }
+
+  return FMC_STATUS_COMPLETE;
+}
+
+/** 
+  * @brief  program a run of halfwords of the external memory, in order.
+  * @param  address: address of the first halfword.
+  * @param  data: halfwords.
+  * @param  count: number of halfwords.
+  * @retval flash_status, the run stops at the first failing halfword.
+  */
+FMC_STATUS_T flash_ee_nor_buffer_program(uint32_t address, const uint16_t* data, uint32_t count)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  for (; count > 0; count--, address += 2, data++)
+  {
+    if ((flash_status = flash_ee_nor_halfword_program(address, *data)) != FMC_STATUS_COMPLETE)
+    {
+      break;
+    }
+  }
+
+  return flash_status;
+}
+
+/** 
+  * @brief  erase a sector of the external memory.
+  * @param  address: sector address.
+  * @retval flash_status
+  */
+FMC_STATUS_T flash_ee_nor_sector_erase(uint32_t address)
+{
+#if (EE_BACKEND == EE_BACKEND_NOR)
+  /* sector erase command sequence */
+  EE_NOR_COMMAND(0x0555, 0x00AA);
+  EE_NOR_COMMAND(0x02AA, 0x0055);
+  EE_NOR_COMMAND(0x0555, 0x0080);
+  EE_NOR_COMMAND(0x0555, 0x00AA);
+  EE_NOR_COMMAND(0x02AA, 0x0055);
+  EE_NOR_WRITE(address, 0x0030);
+
+  return flash_ee_nor_wait(address, EE_NOR_ERASE_TIMEOUT);
+#else
+  uint32_t end_address = address + EE_SECTOR_SIZE;
+
+  /* the SRAM has no erase, fill the sector with the erased value */
+  for (; address < end_address; address += 2)
+  {
+    EE_NOR_WRITE(address, 0xFFFF);
+  }
+
+  return FMC_STATUS_COMPLETE;
+#endif
+}
+
+/** 
+  * @brief  erase consecutive sectors of the external memory, stops at the first failure.
+  * @param  address: first sector address.
+  * @param  count: number of sectors.
+  * @param  fail_address: returns the address of the sector that failed, can be NULL.
+  * @retval flash_status
+  */
+FMC_STATUS_T flash_ee_nor_range_erase(uint32_t address, uint32_t count, uint32_t* fail_address)
+{
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  for (; count > 0; count--, address += EE_NOR_SECTOR_SIZE)
+  {
+    if ((flash_status = flash_ee_nor_sector_erase(address)) != FMC_STATUS_COMPLETE)
+    {
+      if (fail_address != NULL)
+      {
+        *fail_address = address;
+      }
+      break;
+    }
+  }
+
+  return flash_status;
+}
+
+#endif
@@ -0,0 +1,204 @@
+/**
+  **************************************************************************
+  * @file     eeprom_queue.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    the interrupt write queue of the flash eeprom
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include "eeprom_queue.h"
+#include "eeprom_trace.h"
+
+#define EE_QUEUE_ENTRY(address, data)   (((uint32_t)(address) << 16) | (data))  /*!< queue entry of a write */
+#define EE_QUEUE_ADDRESS(entry)         ((uint16_t)((entry) >> 16))              /*!< variable address of a queue entry */
+#define EE_QUEUE_DATA(entry)            ((uint16_t)(entry))                      /*!< data of a queue entry */
+
+/**
+  * @brief  set up an empty write queue.
+  * @param  queue: write queue.
+  * @param  buffer: ring of size words.
+  * @param  size: entries of the ring, a power of 2 up to 0x8000.
+  * @param  policy: overflow policy.
+  * @param  partition: partition written, NULL for the eeprom of flash_ee_init.
+  * @retval queue status:
+  *         - 0: the queue is ready
+  *         - 1: the size is not a power of 2
+  */
+uint16_t flash_ee_queue_init(ee_queue_type* queue, uint32_t* buffer, uint16_t size, ee_queue_policy_type policy, ee_partition_type* partition)
+{
+  if ((size == 0) || (size > 0x8000) || ((size & (size - 1)) != 0))
+  {
+    return 1;
+  }
+
+  queue->buffer     = buffer;
+  queue->size       = size;
+  queue->policy     = policy;
+  queue->partition  = partition;
+  queue->head       = 0;
+  queue->tail       = 0;
+  queue->high_water = 0;
+  queue->coalesced  = 0;
+  queue->dropped    = 0;
+  queue->failed     = 0;
+
+  return 0;
+}
+
+/**
+  * @brief  queue a write, from the single producer of the queue. runs in bounded time
+  *         and may be called from an interrupt.
+  *         the flush only reads the entry at tail after storing tail, so every entry above
+  *         tail is still waiting and its data can be replaced; an entry overwritten while
+  *         the flush reads it is detected from head.
+  * @param  queue: write queue.
+  * @param  address: variable address.
+  * @param  data: data.
+  * @retval put status.
+  */
+ee_queue_status_type flash_ee_queue_put(ee_queue_type* queue, uint16_t address, uint16_t data)
+{
+  uint32_t head = queue->head;
+  uint32_t tail = queue->tail;
+  uint32_t low;
+  uint32_t find;
+  uint32_t mask = queue->size - 1;
+
+  if ((head - tail) < queue->size)
+  {
+    queue->buffer[head & mask] = EE_QUEUE_ENTRY(address, data);
+
+    /* the entry is in place before the flush can see it */
+    __DMB();
+    queue->head = head + 1;
+
+    if ((head + 1 - tail) > queue->high_water)
+    {
+      queue->high_water = (uint16_t)(head + 1 - tail);
+    }
+
+    return EE_QUEUE_QUEUED;
+  }
+
+  if (queue->policy == EE_QUEUE_COALESCE)
+  {
+    /* the waiting entries, the oldest ones may already be overwritten */
+    low = ((head - tail) > queue->size) ? head - queue->size : tail + 1;
+
+    /* the newest entry of the variable, so that no older one is written after it */
+    for (find = head; find != low; find--)
+    {
+      if (EE_QUEUE_ADDRESS(queue->buffer[(find - 1) & mask]) == address)
+      {
+        queue->buffer[(find - 1) & mask] = EE_QUEUE_ENTRY(address, data);
+        queue->coalesced++;
+
+        ee_trace(EE_TRACE_ELIDED, 0, address, data);
+
+        return EE_QUEUE_COALESCED;
+      }
+    }
+  }
+
+  /* overwrite the oldest entry, the flush skips over it */
+  queue->buffer[head & mask] = EE_QUEUE_ENTRY(address, data);
+
+  __DMB();
+  queue->head = head + 1;
+
+  queue->high_water = queue->size;
+
+  return EE_QUEUE_DROPPED;
+}
+
+/**
+  * @brief  get the entries waiting in a queue.
+  * @param  queue: write queue.
+  * @retval number of entries, the size at most.
+  */
+uint16_t flash_ee_queue_depth(ee_queue_type* queue)
+{
+  uint32_t depth = queue->head - queue->tail;
+
+  return (depth > queue->size) ? queue->size : (uint16_t)depth;
+}
+
+/**
+  * @brief  write the queued variables in order, from one thread only. an entry whose write
+  *         fails is counted and dropped, so that it does not hold up the others.
+  * @param  queue: write queue.
+  * @param  count: entries to write at most, 0 for all.
+  * @retval FMC_STATUS_COMPLETE: the queue is empty.
+  *         FMC_STATUS_BUSY: entries remain after count writes.
+  *         else the flash status of the first failed write.
+  */
+FMC_STATUS_T flash_ee_queue_flush(ee_queue_type* queue, uint16_t count)
+{
+  uint16_t written = 0;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t entry;
+  FMC_STATUS_T flash_status;
+  FMC_STATUS_T flush_status = FMC_STATUS_COMPLETE;
+
+  while (1)
+  {
+    head = queue->head;
+    tail = queue->tail;
+
+    if (head == tail)
+    {
+      return flush_status;
+    }
+
+    if ((count != 0) && (written == count))
+    {
+      return (flush_status == FMC_STATUS_COMPLETE) ? FMC_STATUS_BUSY : flush_status;
+    }
+
+    /* the producer lapped the ring, skip to the oldest entry left */
+    if ((head - tail) > queue->size)
+    {
+      queue->dropped += head - queue->size - tail;
+      tail = head - queue->size;
+      queue->tail = tail;
+    }
+
+    /* the entry at tail is never changed by a coalescing put, read it after tail is stored */
+    __DMB();
+    entry = queue->buffer[tail & (queue->size - 1)];
+    __DMB();
+
+    /* overwritten while read, the producer lapped the ring again */
+    if ((queue->head - tail) > queue->size)
+    {
+      continue;
+    }
+
+    if (queue->partition == NULL)
+    {
+      flash_status = flash_ee_data_write(EE_QUEUE_ADDRESS(entry), EE_QUEUE_DATA(entry));
+    }
+    else
+    {
+      flash_status = flash_ee_partition_write(queue->partition, EE_QUEUE_ADDRESS(entry), EE_QUEUE_DATA(entry));
+    }
+
+    if (flash_status != FMC_STATUS_COMPLETE)
+    {
+      queue->failed++;
+
+      if (flush_status == FMC_STATUS_COMPLETE)
+      {
+        flush_status = flash_status;
+      }
+    }
+
+    queue->tail = tail + 1;
+    written++;
+  }
+}
@@ -0,0 +1,73 @@
+/**
+  **************************************************************************
+  * @file     eeprom_registry.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    the typed variable registry of the flash eeprom
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include <stddef.h>
+#include "eeprom_registry.h"
+
+#if (EE_GROUP_COMMIT > 0)
+
+#define EE_REGISTRY_DEFAULT(name, type, value)    value,
+#define EE_REGISTRY_FIELD(name, type, value)      {offsetof(ee_registry_type, name), sizeof(type), EE_KEY_##name},
+
+ee_registry_type ee_registry;                                                  /*!< ram copy, read directly after init */
+
+static const ee_registry_type ee_registry_default =
+{
+  EE_REGISTRY(EE_REGISTRY_DEFAULT)
+};
+
+static const ee_field_type ee_registry_fields[] =
+{
+  EE_REGISTRY(EE_REGISTRY_FIELD)
+};
+
+static uint8_t ee_registry_image[sizeof(ee_registry_type)];                    /*!< registry as last committed */
+static ee_struct_type ee_registry_layout;
+
+/**
+  * @brief  load the registry into its ram copy in one page pass, the variables without
+  *         a record keep their default. call after flash_ee_init.
+  * @param  none
+  * @retval FMC_STATUS_COMPLETE: the registry is loaded.
+  *         FMC_STATUS_ERROR_PG: no valid page, the copy holds the defaults.
+  *         else the status of the deferred init, the copy holds the defaults.
+  */
+FMC_STATUS_T flash_ee_registry_init(void)
+{
+  FMC_STATUS_T flash_status;
+
+  ee_registry = ee_registry_default;
+
+  flash_status = flash_ee_struct_register(&ee_registry_layout, ee_registry_fields,
+                                          sizeof(ee_registry_fields) / sizeof(ee_registry_fields[0]),
+                                          ee_registry_image, sizeof(ee_registry_type));
+
+  if (flash_status != FMC_STATUS_COMPLETE)
+  {
+    return flash_status;
+  }
+
+  return flash_ee_struct_load(&ee_registry_layout, &ee_registry);
+}
+
+/**
+  * @brief  commit the variables of the ram copy changed since the last commit, each
+  *         commit is atomic. after a failure the changes are retried by the next commit.
+  * @param  none
+  * @retval FMC_STATUS_COMPLETE: the registry is committed, else the program status.
+  */
+FMC_STATUS_T flash_ee_registry_commit(void)
+{
+  return flash_ee_struct_save(&ee_registry_layout, &ee_registry);
+}
+
+#endif
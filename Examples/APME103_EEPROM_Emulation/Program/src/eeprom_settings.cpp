@@ -0,0 +1,65 @@
+/**
+  **************************************************************************
+  * @file     eeprom_settings.cpp
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    example settings of the flash eeprom, kept through the c++ facade
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include "eeprom_settings.h"
+#include "eeprom.hpp"
+
+#if (EE_BACKEND == EE_BACKEND_NOR)
+typedef ee::NorBackend settings_backend;
+#elif (EE_BACKEND == EE_BACKEND_SRAM)
+typedef ee::SramBackend settings_backend;
+#else
+typedef ee::FmcBackend settings_backend;
+#endif
+
+/*!< the default eeprom, its geometry and the key range checked at compile time */
+typedef ee::EepromEmulator<settings_backend, EE_PAGE_SIZE, 2, EE_SETTINGS_KEYS> settings;
+
+/**
+  * @brief  write the example keys, the first failing write stops the save.
+  * @param  values: EE_SETTINGS_KEYS values, key settings::key_min first.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_settings_save(const uint16_t* values)
+{
+  uint16_t i;
+  FMC_STATUS_T flash_status = FMC_STATUS_COMPLETE;
+
+  for (i = 0; (i < EE_SETTINGS_KEYS) && (flash_status == FMC_STATUS_COMPLETE); i++)
+  {
+    flash_status = settings::write((uint16_t)(settings::key_min + i), values[i]);
+  }
+
+  return flash_status;
+}
+
+/**
+  * @brief  read the example keys, a key never written reads as 0.
+  * @param  values: EE_SETTINGS_KEYS values, key settings::key_min first.
+  * @retval number of keys not found.
+  */
+uint16_t flash_ee_settings_load(uint16_t* values)
+{
+  uint16_t i;
+  uint16_t missing = 0;
+
+  for (i = 0; i < EE_SETTINGS_KEYS; i++)
+  {
+    if (settings::read((uint16_t)(settings::key_min + i), values[i]) != 0)
+    {
+      values[i] = 0;
+      missing++;
+    }
+  }
+
+  return missing;
+}
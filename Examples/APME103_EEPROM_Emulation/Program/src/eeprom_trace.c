@@ -0,0 +1,488 @@
+/**
+  **************************************************************************
+  * @file     eeprom_trace.c
+  * @version  v1.0.0
+  * @date     2022-08-15
+  * @brief    the operation trace of the flash eeprom
+  **************************************************************************
+
+  *
+  **************************************************************************
+  */
+
+#include <stddef.h>
+#include "eeprom_trace.h"
+
+#if (EE_TRACE_EVENTS > 0) || (EE_CAPTURE_BYTES > 0)
+#include "apm32e10x_dma.h"
+
+/*!< one dma transfer sends a frame */
+#if ((16 + 12 * EE_TRACE_EVENTS) > 0xFFFF)
+#error "EE_TRACE_EVENTS exceeds one dma transfer"
+#endif
+#if ((24 + EE_CAPTURE_BYTES) > 0xFFFF)
+#error "EE_CAPTURE_BYTES exceeds one dma transfer"
+#endif
+#if (EE_CAPTURE_BYTES > 0) && (EE_CAPTURE_BYTES < 16)
+#error "EE_CAPTURE_BYTES below the longest record"
+#endif
+
+static __IO uint8_t ee_send_busy = 0;                                          /*!< a frame is being sent */
+
+/**
+  * @brief  read the cpu cycle counter, the default clock of the trace and the capture.
+  * @param  none
+  * @retval cycles.
+  */
+uint32_t flash_ee_trace_cycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+/**
+  * @brief  start the cpu cycle counter.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_trace_cycles_start(void)
+{
+  if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+  {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+}
+
+/**
+  * @brief  start sending a frame through EE_TRACE_USART, the dma reads the frame while the
+  *         application runs. the frame must not change until flash_ee_trace_send_busy
+  *         reports it sent.
+  * @param  frame: frame.
+  * @param  size: bytes of the frame.
+  * @retval send status:
+  *         - 0: the frame is being sent
+  *         - 1: another frame is being sent
+  */
+uint16_t flash_ee_trace_send(const void* frame, uint32_t size)
+{
+  DMA_Config_T dmaConfig;
+
+  if (ee_send_busy != 0)
+  {
+    return 1;
+  }
+
+  ee_send_busy = 1;
+
+  RCM_EnableAHBPeriphClock(RCM_AHB_PERIPH_DMA1);
+
+  DMA_Disable(EE_TRACE_DMA_CHANNEL);
+  DMA_ClearStatusFlag(EE_TRACE_DMA_FLAG_TC);
+
+  /* memory to usart, one byte per transmit request */
+  dmaConfig.peripheralBaseAddr = (uint32_t)&EE_TRACE_USART->DATA;
+  dmaConfig.memoryBaseAddr     = (uint32_t)frame;
+  dmaConfig.dir                = DMA_DIR_PERIPHERAL_DST;
+  dmaConfig.bufferSize         = size;
+  dmaConfig.peripheralInc      = DMA_PERIPHERAL_INC_DISABLE;
+  dmaConfig.memoryInc          = DMA_MEMORY_INC_ENABLE;
+  dmaConfig.peripheralDataSize = DMA_PERIPHERAL_DATA_SIZE_BYTE;
+  dmaConfig.memoryDataSize     = DMA_MEMORY_DATA_SIZE_BYTE;
+  dmaConfig.loopMode           = DMA_MODE_NORMAL;
+  dmaConfig.priority           = DMA_PRIORITY_LOW;
+  dmaConfig.M2M                = DMA_M2MEN_DISABLE;
+  DMA_Config(EE_TRACE_DMA_CHANNEL, &dmaConfig);
+
+  USART_EnableDMA(EE_TRACE_USART, USART_DMA_TX);
+  DMA_Enable(EE_TRACE_DMA_CHANNEL);
+
+  return 0;
+}
+
+/**
+  * @brief  check whether a frame is still being sent.
+  * @param  none
+  * @retval send status:
+  *         - 0: no frame is being sent
+  *         - 1: a frame is being sent
+  */
+uint16_t flash_ee_trace_send_busy(void)
+{
+  if (ee_send_busy == 0)
+  {
+    return 0;
+  }
+
+  if ((DMA_ReadStatusFlag(EE_TRACE_DMA_FLAG_TC) == RESET) ||
+      (USART_ReadStatusFlag(EE_TRACE_USART, USART_FLAG_TXC) == RESET))
+  {
+    return 1;
+  }
+
+  USART_DisableDMA(EE_TRACE_USART, USART_DMA_TX);
+  DMA_Disable(EE_TRACE_DMA_CHANNEL);
+
+  ee_send_busy = 0;
+
+  return 0;
+}
+#endif
+
+#if (EE_TRACE_EVENTS > 0)
+static ee_trace_frame_type ee_trace_frame;
+static uint32_t (*ee_trace_clock)(void) = NULL;                                /*!< set by flash_ee_trace_init */
+static __IO uint8_t ee_trace_sending = 0;                                      /*!< the frame is being sent, events are missed */
+
+/**
+  * @brief  clear the trace and start recording.
+  * @param  clock: timestamp source, NULL for the cpu cycle counter.
+  * @retval none
+  */
+void flash_ee_trace_init(uint32_t (*clock)(void))
+{
+  if (clock == NULL)
+  {
+    flash_ee_trace_cycles_start();
+
+    clock = flash_ee_trace_cycles;
+  }
+
+  ee_trace_frame.magic      = EE_TRACE_MAGIC;
+  ee_trace_frame.entry_size = sizeof(ee_trace_entry_type);
+  ee_trace_frame.entry_num  = EE_TRACE_EVENTS;
+  ee_trace_frame.head       = 0;
+  ee_trace_frame.missed     = 0;
+  ee_trace_sending          = 0;
+  ee_trace_clock            = clock;
+}
+
+/**
+  * @brief  record an event, from thread or interrupt context. nothing is recorded before
+  *         flash_ee_trace_init.
+  * @param  event: event.
+  * @param  status: flash status, 0 when none.
+  * @param  key: event key.
+  * @param  argument: event argument.
+  * @retval none
+  */
+void flash_ee_trace_record(ee_trace_event_type event, uint8_t status, uint16_t key, uint32_t argument)
+{
+  uint32_t primask;
+  ee_trace_entry_type* entry;
+
+  if (ee_trace_clock == NULL)
+  {
+    return;
+  }
+
+  /* an interrupt recording meanwhile takes the next entry */
+  primask = __get_PRIMASK();
+  __set_PRIMASK(1);
+
+  if (ee_trace_sending != 0)
+  {
+    ee_trace_frame.missed++;
+  }
+  else
+  {
+    entry = &ee_trace_frame.entry[ee_trace_frame.head % EE_TRACE_EVENTS];
+
+    entry->timestamp = ee_trace_clock();
+    entry->event     = (uint8_t)event;
+    entry->status    = status;
+    entry->key       = key;
+    entry->argument  = argument;
+
+    ee_trace_frame.head++;
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  record a failed program or erase with the FMC status flags.
+  * @param  flash_status: status of the program or erase.
+  * @param  address: flash address programmed or erased.
+  * @retval flash_status.
+  */
+FMC_STATUS_T flash_ee_trace_check(FMC_STATUS_T flash_status, uint32_t address)
+{
+  if ((flash_status != FMC_STATUS_COMPLETE) && (ee_trace_clock != NULL))
+  {
+#if (EE_BACKEND == EE_BACKEND_FMC)
+    flash_ee_trace_record(EE_TRACE_FMC_ERROR, (uint8_t)flash_status, (uint16_t)FMC->STS, address);
+#else
+    flash_ee_trace_record(EE_TRACE_FMC_ERROR, (uint8_t)flash_status, 0, address);
+#endif
+  }
+
+  return flash_status;
+}
+
+/**
+  * @brief  start sending the trace frame through EE_TRACE_USART. the recording pauses
+  *         until flash_ee_trace_dump_busy reports the frame sent.
+  * @param  none
+  * @retval dump status:
+  *         - 0: the frame is being sent
+  *         - 1: another frame is being sent, try again later
+  */
+uint16_t flash_ee_trace_dump_start(void)
+{
+  uint32_t primask;
+
+  if (ee_trace_sending != 0)
+  {
+    return 0;
+  }
+
+  /* the recording stops before the dma reads the frame */
+  primask = __get_PRIMASK();
+  __set_PRIMASK(1);
+  ee_trace_sending = 1;
+  __set_PRIMASK(primask);
+
+  if (flash_ee_trace_send(&ee_trace_frame, sizeof(ee_trace_frame)) != 0)
+  {
+    ee_trace_sending = 0;
+
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  check whether the trace frame is still being sent, the recording resumes once
+  *         it is not.
+  * @param  none
+  * @retval dump status:
+  *         - 0: no frame is being sent
+  *         - 1: the frame is being sent
+  */
+uint16_t flash_ee_trace_dump_busy(void)
+{
+  if ((ee_trace_sending == 0) || (flash_ee_trace_send_busy() == 0))
+  {
+    ee_trace_sending = 0;
+
+    return 0;
+  }
+
+  return 1;
+}
+#endif
+
+#if (EE_CAPTURE_BYTES > 0)
+#define EE_CAPTURE_FREE          0                                             /*!< frame free or being filled */
+#define EE_CAPTURE_FULL          1                                             /*!< frame waiting to be sent */
+#define EE_CAPTURE_SENDING       2                                             /*!< frame being sent */
+
+static ee_capture_frame_type ee_capture_frame[2];
+static __IO uint8_t ee_capture_state[2];
+static uint8_t  ee_capture_fill = 0;                                           /*!< frame the records go to */
+static uint32_t (*ee_capture_clock)(void) = NULL;                              /*!< set by flash_ee_capture_init */
+static uint32_t ee_capture_last;                                               /*!< timestamp of the last record */
+static uint32_t ee_capture_sequence;                                           /*!< frames started */
+static uint32_t ee_capture_missed;                                             /*!< records missed */
+
+/**
+  * @brief  start filling a capture frame.
+  * @param  fill: frame to fill.
+  * @retval none
+  */
+void flash_ee_capture_frame_start(uint8_t fill)
+{
+  ee_capture_frame_type* frame = &ee_capture_frame[fill];
+
+  frame->size     = 0;
+  frame->records  = 0;
+  frame->start    = ee_capture_last;
+  frame->sequence = ee_capture_sequence++;
+  frame->missed   = 0;
+
+  ee_capture_fill = fill;
+}
+
+/**
+  * @brief  hand the frame being filled to flash_ee_capture_service and fill the other one,
+  *         which must be free.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_capture_hand_off(void)
+{
+  ee_capture_frame[ee_capture_fill].missed = ee_capture_missed;
+  ee_capture_state[ee_capture_fill] = EE_CAPTURE_FULL;
+
+  /* the next frame starts at the last record */
+  flash_ee_capture_frame_start(ee_capture_fill ^ 1);
+}
+
+/**
+  * @brief  clear the capture and start recording the writes.
+  * @param  clock: timestamp source, NULL for the cpu cycle counter. a gap of 2^32 ticks
+  *         or more between two writes is shortened, a millisecond clock suits long captures.
+  * @param  clock_hz: rate of the clock, ignored for the cpu cycle counter.
+  * @retval none
+  */
+void flash_ee_capture_init(uint32_t (*clock)(void), uint32_t clock_hz)
+{
+  uint8_t i;
+
+  if (clock == NULL)
+  {
+    flash_ee_trace_cycles_start();
+
+    clock    = flash_ee_trace_cycles;
+    clock_hz = SystemCoreClock;
+  }
+
+  for (i = 0; i < 2; i++)
+  {
+    ee_capture_frame[i].magic    = EE_CAPTURE_MAGIC;
+    ee_capture_frame[i].clock_hz = clock_hz;
+    ee_capture_state[i]          = EE_CAPTURE_FREE;
+  }
+
+  ee_capture_last     = clock();
+  ee_capture_sequence = 0;
+  ee_capture_missed   = 0;
+  flash_ee_capture_frame_start(0);
+
+  ee_capture_clock = clock;
+}
+
+/**
+  * @brief  record a write, from thread or interrupt context. nothing is recorded before
+  *         flash_ee_capture_init.
+  * @param  kind: record kind.
+  * @param  address: variable address.
+  * @param  data: data, ignored for increments.
+  * @retval none
+  */
+void flash_ee_capture_record(ee_capture_kind_type kind, uint16_t address, uint16_t data)
+{
+  uint8_t  code[9];
+  uint16_t len = 0;
+  uint16_t i;
+  uint32_t now;
+  uint32_t primask;
+  uint64_t value;
+  ee_capture_frame_type* frame;
+
+  if (ee_capture_clock == NULL)
+  {
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __set_PRIMASK(1);
+
+  now = ee_capture_clock();
+
+  /* ticks since the last record and kind, 7 bits per byte */
+  value = ((uint64_t)(now - ee_capture_last) << 2) | kind;
+
+  do
+  {
+    code[len++] = (uint8_t)((value & 0x7F) | ((value > 0x7F) ? 0x80 : 0));
+    value >>= 7;
+  } while (value != 0);
+
+  code[len++] = (uint8_t)address;
+  code[len++] = (uint8_t)(address >> 8);
+
+  if (kind != EE_CAPTURE_INCREMENT)
+  {
+    code[len++] = (uint8_t)data;
+    code[len++] = (uint8_t)(data >> 8);
+  }
+
+  frame = &ee_capture_frame[ee_capture_fill];
+
+  if ((frame->size + len) > EE_CAPTURE_BYTES)
+  {
+    /* both frames taken, the time of the record counts to the next one */
+    if (ee_capture_state[ee_capture_fill ^ 1] != EE_CAPTURE_FREE)
+    {
+      ee_capture_missed++;
+      __set_PRIMASK(primask);
+
+      return;
+    }
+
+    flash_ee_capture_hand_off();
+
+    frame = &ee_capture_frame[ee_capture_fill];
+  }
+
+  for (i = 0; i < len; i++)
+  {
+    frame->data[frame->size + i] = code[i];
+  }
+
+  frame->size += len;
+  frame->records++;
+  ee_capture_last = now;
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  hand the records of the frame being filled to flash_ee_capture_service, e.g.
+  *         before a reset or periodically. nothing happens while the other frame is taken.
+  * @param  none
+  * @retval none
+  */
+void flash_ee_capture_flush(void)
+{
+  uint32_t primask;
+
+  primask = __get_PRIMASK();
+  __set_PRIMASK(1);
+
+  if ((ee_capture_clock != NULL) && (ee_capture_frame[ee_capture_fill].records != 0) &&
+      (ee_capture_state[ee_capture_fill ^ 1] == EE_CAPTURE_FREE))
+  {
+    flash_ee_capture_hand_off();
+  }
+
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  send the filled capture frames, from the main loop.
+  * @param  none
+  * @retval capture status:
+  *         - 0: no frame waits to be sent
+  *         - 1: a frame waits or is being sent
+  */
+uint16_t flash_ee_capture_service(void)
+{
+  uint8_t i;
+  uint16_t waiting = 0;
+
+  for (i = 0; i < 2; i++)
+  {
+    if ((ee_capture_state[i] == EE_CAPTURE_SENDING) && (flash_ee_trace_send_busy() == 0))
+    {
+      ee_capture_state[i] = EE_CAPTURE_FREE;
+    }
+
+    if ((ee_capture_state[i] == EE_CAPTURE_FULL) &&
+        (flash_ee_trace_send(&ee_capture_frame[i], offsetof(ee_capture_frame_type, data) + ee_capture_frame[i].size) == 0))
+    {
+      ee_capture_state[i] = EE_CAPTURE_SENDING;
+    }
+
+    if (ee_capture_state[i] != EE_CAPTURE_FREE)
+    {
+      waiting = 1;
+    }
+  }
+
+  return waiting;
+}
+#endif
@@ -1,93 +1,151 @@
-/*!
- * @file        main.c
- *
- * @brief       Main program body
- *
- * @version     V1.0.0
- *
- * @date        2021-07-26
- *
- */
-
-#include "main.h"
-#include "eeprom.h"
-
-#define BUF_SIZE               10
-uint16_t buf_write[BUF_SIZE] = {0x2000, 0x2001, 0x2002, 0x2003, 0x2004, 0x2005, 0x2006, 0x2007, 0x2008, 0x2009};
-uint16_t buf_read[BUF_SIZE];
-
-/**
-  * @brief  compare whether the valus of buffer 1 and buffer 2 are equal.
-  * @param  buffer1: buffer 1 address.
-            buffer2: buffer 2 address.
-  * @retval 0: equal.
-  *         1: unequal.
-  */
-uint32_t buffer_compare(uint16_t* buffer1, uint16_t* buffer2, uint32_t len)
-{
-  uint32_t i;
-  
-  for(i = 0; i < len; i++)
-  {
-    if(buffer1[i] != buffer2[i])
-    {
-      return 1;
-    }
-  }
-
-  return 0;
-}
-
-/*!
- * @brief       Main program   
- *
- * @param       None
- *
- * @retval      None
- *
- */
-int main(void)
-{
-    uint16_t i, address;
-	
-    APM_MINI_LEDInit(LED2);
-    APM_MINI_LEDInit(LED3);
-    APM_MINI_LEDOff(LED2);
-    APM_MINI_LEDOff(LED3);
-
-    FMC_Unlock();
-    
-    /* flash eeprom init */
-    flash_ee_init();
-  
-    /* write data to eeprom */  
-    for(i = 0; i < BUF_SIZE; i++)
-    {
-        address = i;
-   
-        flash_ee_data_write(address, buf_write[i]);
-    }
-  
-    /* read data from eeprom */  
-    for(i = 0; i < BUF_SIZE; i++)
-    {
-       address = i;
-    
-       flash_ee_data_read(address, &buf_read[i]);
-    }
-  
-    /* compare data */
-    if(buffer_compare(buf_write, buf_read, BUF_SIZE) == 0) 
-    {
-        APM_MINI_LEDOn(LED2);
-    }
-    else
-    { 
-        APM_MINI_LEDOff(LED2);
-    }  
-
-    while (1)
-    {
-
-    }
-}
+/*!
+ * @file        main.c
+ *
+ * @brief       Main program body
+ *
+ * @version     V1.0.0
+ *
+ * @date        2021-07-26
+ *
+ */
+
+#include "main.h"
+#include "eeprom.h"
+#include "eeprom_registry.h"
+#include "eeprom_settings.h"
+#include "eeprom_log.h"
+#include "eeprom_queue.h"
+#include "eeprom_trace.h"
+
+#define BUF_SIZE               EE_SETTINGS_KEYS
+uint16_t buf_write[BUF_SIZE] = {0x2000, 0x2001, 0x2002, 0x2003, 0x2004, 0x2005, 0x2006, 0x2007, 0x2008, 0x2009};
+uint16_t buf_read[BUF_SIZE];
+
+ee_log_type event_log;
+ee_queue_type fault_queue;
+uint32_t fault_buffer[EE_QUEUE_SIZE];
+
+/**
+  * @brief  compare whether the valus of buffer 1 and buffer 2 are equal.
+  * @param  buffer1: buffer 1 address.
+            buffer2: buffer 2 address.
+  * @retval 0: equal.
+  *         1: unequal.
+  */
+uint32_t buffer_compare(uint16_t* buffer1, uint16_t* buffer2, uint32_t len)
+{
+  uint32_t i;
+  
+  for(i = 0; i < len; i++)
+  {
+    if(buffer1[i] != buffer2[i])
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/*!
+ * @brief       Main program   
+ *
+ * @param       None
+ *
+ * @retval      None
+ *
+ */
+int main(void)
+{
+    uint32_t boot_count = 0;
+#if (EE_TRACE_EVENTS > 0) || (EE_CAPTURE_BYTES > 0)
+    USART_Config_T usartConfig;
+#endif
+	
+    APM_MINI_LEDInit(LED2);
+    APM_MINI_LEDInit(LED3);
+    APM_MINI_LEDOff(LED2);
+    APM_MINI_LEDOff(LED3);
+
+    FMC_Unlock();
+
+#if (EE_TRACE_EVENTS > 0) || (EE_CAPTURE_BYTES > 0)
+    /* the trace and capture frames are sent on COM1, 115200 8N1 */
+    usartConfig.baudRate     = 115200;
+    usartConfig.wordLength   = USART_WORD_LEN_8B;
+    usartConfig.stopBits     = USART_STOP_BIT_1;
+    usartConfig.parity       = USART_PARITY_NONE;
+    usartConfig.mode         = USART_MODE_TX;
+    usartConfig.hardwareFlow = USART_HARDWARE_FLOW_NONE;
+    APM_MINI_COMInit(COM1, &usartConfig);
+#endif
+
+#if (EE_TRACE_EVENTS > 0)
+    /* record the eeprom operations from init on */
+    flash_ee_trace_init(NULL);
+#endif
+
+#if (EE_CAPTURE_BYTES > 0)
+    /* capture the writes for Tools/ee_replay.c */
+    flash_ee_capture_init(NULL, 0);
+#endif
+
+#if (EE_BACKEND != EE_BACKEND_FMC)
+    /* map the external NOR/SRAM through the EMMC */
+    flash_ee_nor_init();
+#endif
+    
+    /* flash eeprom init */
+    flash_ee_init();
+
+#if (EE_GROUP_COMMIT > 0)
+    /* load the typed variables and count this boot */
+    flash_ee_registry_init();
+    EE_REGISTRY_READ(boot_count, &boot_count);
+    boot_count++;
+    EE_REGISTRY_WRITE(boot_count, &boot_count);
+#endif
+
+    /* append this boot to the event log, stamped with the boot count */
+    flash_ee_log_init(&event_log, EE_LOG_BASE_ADDRESS, EE_LOG_PAGE_NUM, 0);
+    flash_ee_log_append(&event_log, boot_count, &boot_count, sizeof(boot_count));
+
+    /* interrupts put their writes to the fault queue, the main loop writes them */
+    flash_ee_queue_init(&fault_queue, fault_buffer, EE_QUEUE_SIZE, EE_QUEUE_COALESCE, NULL);
+  
+    /* write data to eeprom, through the c++ facade of eeprom_settings.cpp */  
+    flash_ee_settings_save(buf_write);
+  
+    /* read data from eeprom */  
+    flash_ee_settings_load(buf_read);
+  
+    /* compare data */
+    if(buffer_compare(buf_write, buf_read, BUF_SIZE) == 0) 
+    {
+        APM_MINI_LEDOn(LED2);
+    }
+    else
+    { 
+        APM_MINI_LEDOff(LED2);
+    }  
+
+#if (EE_TRACE_EVENTS > 0)
+    /* send what the boot did, Tools/ee_trace_decode.c prints it */
+    flash_ee_trace_dump_start();
+#endif
+
+    while (1)
+    {
+        flash_ee_queue_flush(&fault_queue, 0);
+
+#if (EE_TRACE_EVENTS > 0)
+        /* the recording resumes once the frame is sent */
+        flash_ee_trace_dump_busy();
+#endif
+
+#if (EE_CAPTURE_BYTES > 0)
+        /* send the filled capture frames */
+        flash_ee_capture_service();
+#endif
+    }
+}
@@ -1,52 +1,74 @@
-/*!
- * @file       apm32e10x_crc.h
- *
- * @brief      This file contains all the functions prototypes for the CRC firmware library
- *
- * @version    V1.0.0
- *
- * @date       2021-07-26
- *
- */
-
-#ifndef __APM32E10X_CRC_H
-#define __APM32E10X_CRC_H
-
-#include "apm32e10x.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/** @addtogroup Peripherals_Library Standard Peripheral Library
-  @{
-*/
-
-/** @addtogroup CRC_Driver CRC Driver
-  @{
-*/
-
-/** @addtogroup CRC_Fuctions Fuctions
-  @{
-*/
-
-/** Reset DATA */
-void CRC_ResetDATA(void);
-
-/** Operation functions */
-uint32_t CRC_CalculateCRC(uint32_t data);
-uint32_t CRC_CalculateBlockCRC(uint32_t *buf, uint32_t bufLen);
-uint32_t CRC_ReadCRC(void);
-void CRC_WriteIDRegister(uint8_t inData);
-uint8_t CRC_ReadIDRegister(void);
-
-/**@} end of group CRC_Fuctions*/
-/**@} end of group CRC_Driver */
-/**@} end of group Peripherals_Library*/
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif /* __APM32E10X_CRC_H */
-
+/*!
+ * @file       apm32e10x_crc.h
+ *
+ * @brief      This file contains all the functions prototypes for the CRC firmware library
+ *
+ * @version    V1.0.0
+ *
+ * @date       2021-07-26
+ *
+ */
+
+#ifndef __APM32E10X_CRC_H
+#define __APM32E10X_CRC_H
+
+#include "apm32e10x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup Peripherals_Library Standard Peripheral Library
+  @{
+*/
+
+/** @addtogroup CRC_Driver CRC Driver
+  @{
+*/
+
+/** @addtogroup CRC_Enumerations Enumerations
+  @{
+*/
+
+/**
+ * @brief CRC DMA transfer status
+ */
+typedef enum
+{
+    CRC_DMA_STATUS_BUSY,      //!< the transfer is running
+    CRC_DMA_STATUS_COMPLETE,  //!< all words are fed to the CRC unit
+    CRC_DMA_STATUS_ERROR      //!< a transfer error stopped the transfer
+} CRC_DMA_STATUS_T;
+
+/**@} end of group CRC_Enumerations*/
+
+/** @addtogroup CRC_Fuctions Fuctions
+  @{
+*/
+
+/** Reset DATA */
+void CRC_ResetDATA(void);
+
+/** Operation functions */
+uint32_t CRC_CalculateCRC(uint32_t data);
+uint32_t CRC_CalculateBlockCRC(uint32_t *buf, uint32_t bufLen);
+uint32_t CRC_ReadCRC(void);
+void CRC_WriteIDRegister(uint8_t inData);
+uint8_t CRC_ReadIDRegister(void);
+
+/** DMA operation functions */
+void CRC_StartBlockCRCDMA(DMA_Channel_T *channel, const uint32_t *buf, uint16_t bufLen, uint8_t interrupt);
+CRC_DMA_STATUS_T CRC_ReadDMAStatus(DMA_Channel_T *channel);
+uint32_t CRC_FinishBlockCRCDMA(DMA_Channel_T *channel);
+uint8_t CRC_CalculateBlockCRCDMA(DMA_Channel_T *channel, const uint32_t *buf, uint32_t bufLen, uint32_t *crc);
+
+/**@} end of group CRC_Fuctions*/
+/**@} end of group CRC_Driver */
+/**@} end of group Peripherals_Library*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APM32E10X_CRC_H */
+
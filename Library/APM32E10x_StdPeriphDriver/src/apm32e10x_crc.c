@@ -1,112 +1,253 @@
-/*!
- * @file      apm32e10x_crc.c
- *
- * @brief     This file provides all the CRC firmware functions
- *
- * @version   V1.0.0
- *
- * @date      2021-07-26
- *
- */
-
-#include "apm32e10x_crc.h"
-
-/** @addtogroup Peripherals_Library Standard Peripheral Library
-  @{
-*/
-
-/** @addtogroup CRC_Driver CRC Driver
-  @{
-*/
-
-/** @addtogroup CRC_Fuctions Fuctions
-  @{
-*/
-
-/*!
- * @brief     Reset CRC data register.
- *
- * @param     None
- *
- * @retval    None
- *
- * @note
- */
-void CRC_ResetDATA(void)
-{
-    CRC->CTRL_B.RST = BIT_SET;
-}
-
-/*!
- * @brief     Calculate CRC of a 32bit data word.
- *
- * @param     data: a data word to compute its CRC.
- *                  This parameter can be a 32bit value:
- *
- * @retval    A 32-bit CRC value
- */
-uint32_t CRC_CalculateCRC(uint32_t data)
-{
-    CRC->DATA = data;
-
-    return (CRC->DATA);
-}
-
-/*!
- * @brief     Computes the 32-bit CRC of a given buffer of data word(32-bit).
- *
- * @param     buf: Pointer to the buffer containing the data to be computed.
- *
- * @param     bufLen: The length of buffer which is computed.
- *
- * @retval    A 32-bit CRC value
- */
-uint32_t CRC_CalculateBlockCRC(uint32_t *buf, uint32_t bufLen)
-{
-    while(bufLen--)
-    {
-        CRC->DATA = *buf++;
-    }
-
-    return (CRC->DATA);
-}
-
-/*!
- * @brief     Returns the current CRC value.
- *
- * @param     None
- *
- * @retval    A 32-bit CRC value
- */
-uint32_t CRC_ReadCRC(void)
-{
-    return (CRC->DATA);
-}
-
-/*!
- * @brief     Saves a 8bit data in the Independent Data register(INDATA).
- *
- * @param     inData: a 8-bit value to be stored in the ID register
- *
- * @retval    None
- */
-void CRC_WriteIDRegister(uint8_t inData)
-{
-    CRC->INDATA = inData;
-}
-
-/*!
- * @brief      Reads a 8-bit data saved in the Independent Data register(INDATA).
- *
- * @param      None
- *
- * @retval     a 8-bit value from the INDATA register
- */
-uint8_t CRC_ReadIDRegister(void)
-{
-    return (CRC->INDATA);
-}
-
-/**@} end of group CRC_Fuctions*/
-/**@} end of group CRC_Driver*/
-/**@} end of group Peripherals_Library*/
+/*!
+ * @file      apm32e10x_crc.c
+ *
+ * @brief     This file provides all the CRC firmware functions
+ *
+ * @version   V1.0.0
+ *
+ * @date      2021-07-26
+ *
+ */
+
+#include "apm32e10x_crc.h"
+#include "apm32e10x_dma.h"
+
+/** @addtogroup Peripherals_Library Standard Peripheral Library
+  @{
+*/
+
+/** @addtogroup CRC_Driver CRC Driver
+  @{
+*/
+
+/** @addtogroup CRC_Fuctions Fuctions
+  @{
+*/
+
+/*!
+ * @brief     Reset CRC data register.
+ *
+ * @param     None
+ *
+ * @retval    None
+ *
+ * @note
+ */
+void CRC_ResetDATA(void)
+{
+    CRC->CTRL_B.RST = BIT_SET;
+}
+
+/*!
+ * @brief     Calculate CRC of a 32bit data word.
+ *
+ * @param     data: a data word to compute its CRC.
+ *                  This parameter can be a 32bit value:
+ *
+ * @retval    A 32-bit CRC value
+ */
+uint32_t CRC_CalculateCRC(uint32_t data)
+{
+    CRC->DATA = data;
+
+    return (CRC->DATA);
+}
+
+/*!
+ * @brief     Computes the 32-bit CRC of a given buffer of data word(32-bit).
+ *
+ * @param     buf: Pointer to the buffer containing the data to be computed.
+ *
+ * @param     bufLen: The length of buffer which is computed.
+ *
+ * @retval    A 32-bit CRC value
+ */
+uint32_t CRC_CalculateBlockCRC(uint32_t *buf, uint32_t bufLen)
+{
+    while(bufLen--)
+    {
+        CRC->DATA = *buf++;
+    }
+
+    return (CRC->DATA);
+}
+
+/*!
+ * @brief     Starts a DMA transfer that feeds a buffer of data word(32-bit) into the CRC unit.
+ *
+ * @param     channel: a free DMA channel, DMA1_channelx(x can be from 1 to 7) or
+ *                     DMA2_channely(y can be from 1 to 5).
+ *
+ * @param     buf: Pointer to the buffer containing the data to be computed, flash or SRAM.
+ *
+ * @param     bufLen: The length of buffer which is computed, 1 to 65535 words.
+ *
+ * @param     interrupt: ENABLE to raise the transfer complete and transfer error
+ *                       interrupts of the channel, DISABLE to poll CRC_ReadDMAStatus.
+ *
+ * @retval    None
+ *
+ * @note      The DMA clock must be enabled. The CRC keeps accumulating from its current
+ *            value, call CRC_ResetDATA first to start a new CRC. Longer buffers are fed
+ *            in several transfers.
+ */
+void CRC_StartBlockCRCDMA(DMA_Channel_T *channel, const uint32_t *buf, uint16_t bufLen, uint8_t interrupt)
+{
+    DMA_Config_T dmaConfig;
+
+    DMA_Disable(channel);
+
+    /** Memory to memory, the buffer is the incrementing source */
+    dmaConfig.peripheralBaseAddr = (uint32_t)buf;
+    dmaConfig.memoryBaseAddr = (uint32_t)&CRC->DATA;
+    dmaConfig.dir = DMA_DIR_PERIPHERAL_SRC;
+    dmaConfig.bufferSize = bufLen;
+    dmaConfig.peripheralInc = DMA_PERIPHERAL_INC_ENABLE;
+    dmaConfig.memoryInc = DMA_MEMORY_INC_DISABLE;
+    dmaConfig.peripheralDataSize = DMA_PERIPHERAL_DATA_SIZE_WOED;
+    dmaConfig.memoryDataSize = DMA_MEMORY_DATA_SIZE_WOED;
+    dmaConfig.loopMode = DMA_MODE_NORMAL;
+    dmaConfig.priority = DMA_PRIORITY_LOW;
+    dmaConfig.M2M = DMA_M2MEN_ENABLE;
+    DMA_Config(channel, &dmaConfig);
+
+    if(interrupt == ENABLE)
+    {
+        DMA_EnableInterrupt(channel, DMA_INT_TC | DMA_INT_TERR);
+    }
+    else
+    {
+        DMA_DisableInterrupt(channel, DMA_INT_TC | DMA_INT_HT | DMA_INT_TERR);
+    }
+
+    DMA_Enable(channel);
+}
+
+/*!
+ * @brief     Reads the state of the DMA transfer started by CRC_StartBlockCRCDMA.
+ *
+ * @param     channel: the DMA channel of the transfer.
+ *
+ * @retval    Returns the transfer state. It can be one of value:
+ *                 @arg CRC_DMA_STATUS_BUSY: the transfer is running
+ *                 @arg CRC_DMA_STATUS_COMPLETE: all words are fed to the CRC unit
+ *                 @arg CRC_DMA_STATUS_ERROR: a transfer error stopped the transfer, the
+ *                      CRC unit holds the CRC of part of the buffer
+ *
+ * @note      A transfer error disables the channel before its data number reaches zero.
+ *            The state is valid until CRC_FinishBlockCRCDMA disables the channel.
+ */
+CRC_DMA_STATUS_T CRC_ReadDMAStatus(DMA_Channel_T *channel)
+{
+    if(DMA_ReadDataNumber(channel) == 0)
+    {
+        return CRC_DMA_STATUS_COMPLETE;
+    }
+
+    return (channel->CHCFG_B.CHEN == BIT_SET) ? CRC_DMA_STATUS_BUSY : CRC_DMA_STATUS_ERROR;
+}
+
+/*!
+ * @brief     Ends the DMA transfer started by CRC_StartBlockCRCDMA, to be called when
+ *            CRC_ReadDMAStatus no longer returns CRC_DMA_STATUS_BUSY or from the channel
+ *            interrupt handler.
+ *
+ * @param     channel: the DMA channel of the transfer.
+ *
+ * @retval    A 32-bit CRC value
+ *
+ * @note      The transfer complete flag of the channel is left to the caller.
+ */
+uint32_t CRC_FinishBlockCRCDMA(DMA_Channel_T *channel)
+{
+    DMA_DisableInterrupt(channel, DMA_INT_TC | DMA_INT_HT | DMA_INT_TERR);
+    DMA_Disable(channel);
+
+    return (CRC->DATA);
+}
+
+/*!
+ * @brief     Computes the 32-bit CRC of a given buffer of data word(32-bit) with a DMA
+ *            channel, polling for its completion.
+ *
+ * @param     channel: a free DMA channel, DMA1_channelx(x can be from 1 to 7) or
+ *                     DMA2_channely(y can be from 1 to 5).
+ *
+ * @param     buf: Pointer to the buffer containing the data to be computed.
+ *
+ * @param     bufLen: The length of buffer which is computed.
+ *
+ * @param     crc: Pointer to the 32-bit CRC value, written only when all words are computed.
+ *
+ * @retval    SUCCESS: all words are computed
+ *            ERROR  : a DMA transfer error stopped the computation, the CRC unit holds
+ *                     the CRC of part of the buffer
+ *
+ * @note      The DMA clock must be enabled. Like CRC_CalculateBlockCRC the CRC is not reset.
+ */
+uint8_t CRC_CalculateBlockCRCDMA(DMA_Channel_T *channel, const uint32_t *buf, uint32_t bufLen, uint32_t *crc)
+{
+    uint16_t len;
+    CRC_DMA_STATUS_T status;
+
+    while(bufLen)
+    {
+        len = (bufLen > 0xFFFF) ? 0xFFFF : (uint16_t)bufLen;
+
+        CRC_StartBlockCRCDMA(channel, buf, len, DISABLE);
+        while((status = CRC_ReadDMAStatus(channel)) == CRC_DMA_STATUS_BUSY);
+
+        if(status == CRC_DMA_STATUS_ERROR)
+        {
+            CRC_FinishBlockCRCDMA(channel);
+            return ERROR;
+        }
+
+        buf += len;
+        bufLen -= len;
+    }
+
+    *crc = CRC_FinishBlockCRCDMA(channel);
+
+    return SUCCESS;
+}
+
+/*!
+ * @brief     Returns the current CRC value.
+ *
+ * @param     None
+ *
+ * @retval    A 32-bit CRC value
+ */
+uint32_t CRC_ReadCRC(void)
+{
+    return (CRC->DATA);
+}
+
+/*!
+ * @brief     Saves a 8bit data in the Independent Data register(INDATA).
+ *
+ * @param     inData: a 8-bit value to be stored in the ID register
+ *
+ * @retval    None
+ */
+void CRC_WriteIDRegister(uint8_t inData)
+{
+    CRC->INDATA = inData;
+}
+
+/*!
+ * @brief      Reads a 8-bit data saved in the Independent Data register(INDATA).
+ *
+ * @param      None
+ *
+ * @retval     a 8-bit value from the INDATA register
+ */
+uint8_t CRC_ReadIDRegister(void)
+{
+    return (CRC->INDATA);
+}
+
+/**@} end of group CRC_Fuctions*/
+/**@} end of group CRC_Driver*/
+/**@} end of group Peripherals_Library*/